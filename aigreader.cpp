@@ -0,0 +1,421 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   aigreader.cpp
+ * Note: Binary AIGER reader, see aigreader.h.
+ *       Header "aig M I L O A [B C J F]", then the latch, output, bad, constraint, justice
+ *       and fairness lines, then the AND gates as pairs of delta varints. The symbols and
+ *       comments after the gates are not read, the Model does not use them.
+ *       Compressed files are read in blocks of BLOCK bytes through zlib or liblzma, and
+ *       handed to aiger_read_generic one character at a time.
+ */
+
+#include "aigreader.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <zlib.h>
+#ifdef ENABLE_LZMA
+#include <lzma.h>
+#endif
+#include <vector>
+using namespace std;
+
+namespace car
+{
+	class Mapped
+	{
+	public:
+		Mapped (const char* file) : data_ (NULL), size_ (0)
+		{
+			int fd = open (file, O_RDONLY);
+			if (fd < 0)
+				return;
+			struct stat st;
+			if (fstat (fd, &st) == 0 && st.st_size > 0)
+			{
+				void* p = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED)
+				{
+					data_ = (const unsigned char*) p;
+					size_ = st.st_size;
+					madvise (p, size_, MADV_SEQUENTIAL);
+				}
+			}
+			close (fd);
+		}
+		~Mapped ()
+		{
+			if (data_ != NULL)
+				munmap ((void*) data_, size_);
+		}
+
+		const unsigned char* data_;
+		size_t size_;
+	};
+
+	class Parser
+	{
+	public:
+		Parser (const unsigned char* p, const unsigned char* end) : p_ (p), end_ (end) {}
+
+		//unsigned decimal
+		bool number (unsigned& res)
+		{
+			if (p_ == end_ || *p_ < '0' || *p_ > '9')
+				return false;
+			unsigned long long n = 0;
+			while (p_ != end_ && *p_ >= '0' && *p_ <= '9')
+			{
+				n = n * 10 + (*p_++ - '0');
+				if (n > 0xffffffffULL)
+					return false;
+			}
+			res = (unsigned) n;
+			return true;
+		}
+
+		bool separator (const char sep)
+		{
+			if (p_ == end_ || *p_ != (unsigned char) sep)
+				return false;
+			p_ ++;
+			return true;
+		}
+
+		//7 bits per byte from the lowest, the high bit set on all the bytes but the last
+		inline bool delta (unsigned& res)
+		{
+			unsigned x = 0, i = 0, ch;
+			do
+			{
+				if (p_ == end_ || i > 28)
+					return false;
+				ch = *p_++;
+				x |= (ch & 0x7f) << i;
+				i += 7;
+			} while (ch & 0x80);
+			res = x;
+			return true;
+		}
+
+	private:
+		const unsigned char* p_;
+		const unsigned char* end_;
+	};
+
+	static AigerRead fail (string& error, const string& msg)
+	{
+		error = msg;
+		return AIGER_READ_ERROR;
+	}
+
+	static bool literal (Parser& in, unsigned& lit, const unsigned max_lit)
+	{
+		return in.number (lit) && in.separator ('\n') && lit <= max_lit;
+	}
+
+	AigerRead read_mapped_aiger (aiger* aig, const char* file, string& error)
+	{
+		Mapped m (file);
+		if (m.data_ == NULL || m.size_ < 4 || m.data_[0] != 'a' || m.data_[1] != 'i' || m.data_[2] != 'g' || m.data_[3] != ' ')
+			return AIGER_READ_SKIP;
+
+		Parser in (m.data_ + 4, m.data_ + m.size_);
+		//M I L O A, and B C J F of AIGER 1.9 when present
+		unsigned h[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+		int n = 0;
+		while (true)
+		{
+			if (n == 9 || !in.number (h[n++]))
+				return fail (error, "invalid binary header");
+			if (in.separator ('\n'))
+				break;
+			if (!in.separator (' '))
+				return fail (error, "invalid binary header");
+		}
+		if (n < 5)
+			return fail (error, "invalid binary header");
+		const unsigned M = h[0], I = h[1], L = h[2], O = h[3], A = h[4], B = h[5], C = h[6], J = h[7], F = h[8];
+		if ((unsigned long long) I + L + A != M || M > 0x7fffffffU / 2)
+			return fail (error, "M does not match I + L + A in binary header");
+		//every line takes two bytes and every gate at least two, so larger counts cannot be read
+		if ((unsigned long long) L + O + B + C + J + F + 2ULL * A > m.size_)
+			return fail (error, "binary header exceeds file size");
+		const unsigned max_lit = 2 * M + 1;
+
+		for (unsigned i = 1; i <= I; i ++)
+			aiger_add_input (aig, 2 * i, 0);
+
+		for (unsigned i = 0; i < L; i ++)
+		{
+			unsigned next, reset = 0;
+			if (!in.number (next))
+				return fail (error, "invalid latch");
+			if (in.separator (' '))
+			{
+				if (!literal (in, reset, max_lit) || (reset != 0 && reset != 1 && reset != 2 * (I+i+1)))
+					return fail (error, "invalid latch reset");
+			}
+			else if (!in.separator ('\n'))
+				return fail (error, "invalid latch");
+			if (next > max_lit)
+				return fail (error, "latch next literal exceeds maximum");
+			unsigned lit = 2 * (I+i+1);
+			aiger_add_latch (aig, lit, next, 0);
+			if (reset != 0)
+				aiger_add_reset (aig, lit, reset);
+		}
+
+		unsigned lit;
+		for (unsigned i = 0; i < O; i ++)
+		{
+			if (!literal (in, lit, max_lit))
+				return fail (error, "invalid output");
+			aiger_add_output (aig, lit, 0);
+		}
+		for (unsigned i = 0; i < B; i ++)
+		{
+			if (!literal (in, lit, max_lit))
+				return fail (error, "invalid bad state property");
+			aiger_add_bad (aig, lit, 0);
+		}
+		for (unsigned i = 0; i < C; i ++)
+		{
+			if (!literal (in, lit, max_lit))
+				return fail (error, "invalid invariant constraint");
+			aiger_add_constraint (aig, lit, 0);
+		}
+		vector<unsigned> sizes (J);
+		for (unsigned i = 0; i < J; i ++)
+		{
+			if (!in.number (sizes[i]) || !in.separator ('\n') || sizes[i] > m.size_)
+				return fail (error, "invalid justice property size");
+		}
+		for (unsigned i = 0; i < J; i ++)
+		{
+			vector<unsigned> lits (sizes[i]);
+			for (unsigned j = 0; j < sizes[i]; j ++)
+			{
+				if (!literal (in, lits[j], max_lit))
+					return fail (error, "invalid justice literal");
+			}
+			aiger_add_justice (aig, sizes[i], lits.empty () ? NULL : &lits[0], 0);
+		}
+		for (unsigned i = 0; i < F; i ++)
+		{
+			if (!literal (in, lit, max_lit))
+				return fail (error, "invalid fairness constraint");
+			aiger_add_fairness (aig, lit, 0);
+		}
+
+		//the deltas only reach smaller literals, so the gates are acyclic and every
+		//variable up to M is defined, which is all aiger_check would tell
+		unsigned lhs = 2 * (I+L);
+		for (unsigned i = 0; i < A; i ++)
+		{
+			lhs += 2;
+			unsigned d0, d1;
+			if (!in.delta (d0) || d0 == 0 || d0 > lhs)
+				return fail (error, "invalid AND delta");
+			unsigned rhs0 = lhs - d0;
+			if (!in.delta (d1) || d1 > rhs0)
+				return fail (error, "invalid AND delta");
+			aiger_add_and (aig, lhs, rhs0, rhs0 - d1);
+		}
+		return AIGER_READ_OK;
+	}
+
+	static const int BLOCK = 1 << 16;
+
+	//decompressed bytes for aiger_read_generic
+	class Decompressor
+	{
+	public:
+		Decompressor () : pos_ (buf_), end_ (buf_), failed_ (false) {}
+		virtual ~Decompressor () {}
+
+		static int get (void* state)
+		{
+			Decompressor* d = (Decompressor*) state;
+			if (d->pos_ == d->end_)
+			{
+				int n = d->fill (d->buf_, BLOCK);
+				if (n <= 0)
+				{
+					d->failed_ = d->failed_ || n < 0;
+					return EOF;
+				}
+				d->pos_ = d->buf_;
+				d->end_ = d->buf_ + n;
+			}
+			return *d->pos_++;
+		}
+
+		inline bool failed () const {return failed_;}
+
+	protected:
+		//decompress up to size bytes into buf, return the number of bytes, 0 at the end, -1 on errors
+		virtual int fill (unsigned char* buf, const int size) = 0;
+
+	private:
+		unsigned char buf_[BLOCK];
+		unsigned char* pos_;
+		unsigned char* end_;
+		bool failed_;
+	};
+
+	class GzipDecompressor : public Decompressor
+	{
+	public:
+		GzipDecompressor (const char* file) : in_ (gzopen (file, "rb")) {}
+		~GzipDecompressor () {if (in_ != NULL) gzclose (in_);}
+
+		inline bool opened () const {return in_ != NULL;}
+
+	protected:
+		int fill (unsigned char* buf, const int size)
+		{
+			return gzread (in_, buf, size);
+		}
+
+	private:
+		gzFile in_;
+	};
+
+#ifdef ENABLE_LZMA
+	class XzDecompressor : public Decompressor
+	{
+	public:
+		XzDecompressor (const char* file) : in_ (fopen (file, "rb")), done_ (false)
+		{
+			lzma_stream init = LZMA_STREAM_INIT;
+			strm_ = init;
+			if (in_ != NULL && lzma_stream_decoder (&strm_, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+			{
+				fclose (in_);
+				in_ = NULL;
+			}
+		}
+		~XzDecompressor ()
+		{
+			if (in_ != NULL)
+			{
+				lzma_end (&strm_);
+				fclose (in_);
+			}
+		}
+
+		inline bool opened () const {return in_ != NULL;}
+
+	protected:
+		int fill (unsigned char* buf, const int size)
+		{
+			strm_.next_out = buf;
+			strm_.avail_out = size;
+			while (strm_.avail_out == size && !done_)
+			{
+				lzma_action action = LZMA_RUN;
+				if (strm_.avail_in == 0)
+				{
+					strm_.next_in = inbuf_;
+					strm_.avail_in = fread (inbuf_, 1, BLOCK, in_);
+					if (ferror (in_))
+						return -1;
+					if (feof (in_))
+						action = LZMA_FINISH;
+				}
+				lzma_ret ret = lzma_code (&strm_, action);
+				if (ret == LZMA_STREAM_END)
+					done_ = true;
+				else if (ret != LZMA_OK)
+					return -1;
+			}
+			return size - strm_.avail_out;
+		}
+
+	private:
+		FILE* in_;
+		lzma_stream strm_;
+		unsigned char inbuf_[BLOCK];
+		bool done_;
+	};
+#endif
+
+	template <class D>
+	static AigerRead read_from (D& in, aiger* aig, const char* file, string& error)
+	{
+		if (!in.opened ())
+			return fail (error, string ("can not read '") + file + "'");
+		const char* err = aiger_read_generic (aig, &in, Decompressor::get);
+		if (in.failed ())
+			return fail (error, string ("corrupted compressed file '") + file + "'");
+		if (err != NULL)
+			return fail (error, err);
+		return AIGER_READ_OK;
+	}
+
+	AigerRead read_compressed_aiger (aiger* aig, const char* file, string& error)
+	{
+		if (has_suffix (file, ".gz"))
+		{
+			GzipDecompressor in (file);
+			return read_from (in, aig, file, error);
+		}
+#ifdef ENABLE_LZMA
+		if (has_suffix (file, ".xz"))
+		{
+			XzDecompressor in (file);
+			return read_from (in, aig, file, error);
+		}
+#endif
+		return AIGER_READ_SKIP;
+	}
+
+	bool has_suffix (const string& name, const string& suffix)
+	{
+		return name.size () >= suffix.size () && name.compare (name.size ()-suffix.size (), suffix.size (), suffix) == 0;
+	}
+
+	bool read_aiger (aiger* aig, const char* file, string& error)
+	{
+		AigerRead read = read_compressed_aiger (aig, file, error);
+		if (read == AIGER_READ_SKIP)
+			read = read_mapped_aiger (aig, file, error);
+		if (read == AIGER_READ_SKIP && aiger_open_and_read_from_file (aig, file) != NULL)
+		{
+			error = aiger_error (aig);
+			return false;
+		}
+		return read != AIGER_READ_ERROR;
+	}
+
+	string aiger_file_name (const string& path)
+	{
+		size_t start = path.find_last_of ("/");
+		string res = path.substr (start == string::npos ? 0 : start+1);
+		//remove .gz or .xz, then .aig or .aag
+		if (has_suffix (res, ".gz") || has_suffix (res, ".xz"))
+			res.erase (res.size ()-3);
+		if (has_suffix (res, ".aig") || has_suffix (res, ".aag"))
+			res.erase (res.size ()-4);
+		return res;
+	}
+}
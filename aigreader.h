@@ -0,0 +1,57 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   aigreader.h
+ * Note: Reader of binary AIGER files mapped in memory. The AND section is decoded
+ *       in one loop over the mapped bytes instead of the character callbacks of aiger.c,
+ *       which is still used for ASCII files.
+ *       Compressed files (.gz, and .xz when built with liblzma) are decompressed in memory
+ *       while aiger.c parses them, instead of through gunzip or a temporary file.
+ */
+
+#ifndef AIG_READER_H
+#define	AIG_READER_H
+
+extern "C" {
+#include "aiger.h"
+}
+#include <string>
+
+namespace car
+{
+	enum AigerRead {AIGER_READ_OK, AIGER_READ_ERROR, AIGER_READ_SKIP};
+
+	//read file into aig, which must be empty. AIGER_READ_SKIP (aig untouched) for ASCII files
+	//and the files which cannot be mapped, they are left to aiger_open_and_read_from_file
+	AigerRead read_mapped_aiger (aiger* aig, const char* file, std::string& error);
+
+	//read file into aig, which must be empty. AIGER_READ_SKIP (aig untouched) for uncompressed files
+	AigerRead read_compressed_aiger (aiger* aig, const char* file, std::string& error);
+
+	//read file into aig, which must be empty: compressed files are decompressed in memory,
+	//binary files are mapped, the ASCII ones go through aiger.c. Return false with error on failure
+	bool read_aiger (aiger* aig, const char* file, std::string& error);
+
+	//file name without its directory and its .aig/.aag (and .gz/.xz) suffix, which names the outputs
+	std::string aiger_file_name (const std::string& path);
+
+	//whether name ends with suffix
+	bool has_suffix (const std::string& name, const std::string& suffix);
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   autotune.cpp
+ * Note: See autotune.h.
+ */
+
+#include "autotune.h"
+#include <sstream>
+#include <algorithm>
+using namespace std;
+
+namespace car
+{
+	static const char* tech_names[TECH_NUM] = {"dead", "muc", "partial", "propagate"};
+	//below this rate of hits, t is not worth more than MAX_SHARE of the time
+	static const double MIN_RATE[TECH_NUM] = {0.05, 0.1, 0.1, 0.05};
+	static const double MAX_SHARE = 0.1;
+	static const long long MIN_TRIES = 8;
+	//the levels are measured together until they take that long, shorter ones are noise
+	static const double MIN_SECONDS = 0.05;
+	static const int FIRST_BACKOFF = 2, MAX_BACKOFF = 64;
+
+	AutoTuner::AutoTuner (const bool usable[TECH_NUM])
+	{
+		for (int t = 0; t < TECH_NUM; t ++)
+		{
+			usable_[t] = on_[t] = usable[t];
+			wait_[t] = 0;
+			backoff_[t] = FIRST_BACKOFF;
+			retried_[t] = false;
+		}
+		clear_counts ();
+	}
+
+	string AutoTuner::next_level ()
+	{
+		double seconds = chrono::duration<double> (chrono::steady_clock::now () - start_).count ();
+		if (seconds < MIN_SECONDS)
+			return "";
+		ostringstream out;
+		for (int t = 0; t < TECH_NUM; t ++)
+		{
+			if (!usable_[t])
+				continue;
+			if (!on_[t])
+			{
+				if (-- wait_[t] > 0)
+					continue;
+				on_[t] = true;
+				retried_[t] = true;
+				out << (out.tellp () > 0 ? ", " : "") << tech_names[t] << " on again";
+				continue;
+			}
+			if (tries_[t] < MIN_TRIES)
+				continue;
+			double rate = double (hits_[t]) / tries_[t];
+			double share = seconds_[t] / seconds;
+			//a technique which never succeeds is not worth any time
+			if (share > MAX_SHARE ? rate < MIN_RATE[t] : hits_[t] == 0)
+			{
+				if (retried_[t])
+					backoff_[t] = min (2 * backoff_[t], MAX_BACKOFF);
+				wait_[t] = backoff_[t];
+				on_[t] = false;
+				out << (out.tellp () > 0 ? ", " : "") << tech_names[t] << " off (" << int (100 * rate) << "% hits, "
+				    << int (100 * share) << "% of the time)";
+			}
+			else if (retried_[t])
+				backoff_[t] = FIRST_BACKOFF;
+			retried_[t] = false;
+		}
+		clear_counts ();
+		return out.str ();
+	}
+
+	void AutoTuner::clear_counts ()
+	{
+		for (int t = 0; t < TECH_NUM; t ++)
+		{
+			tries_[t] = hits_[t] = 0;
+			seconds_[t] = 0.0;
+		}
+		start_ = chrono::steady_clock::now ();
+	}
+}
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   autotune.h
+ * Note: The controller of -auto. The Checker tells it what each technique cost and gained
+ *       at a frame level: the dead state checks and the dead states found, the literals of
+ *       the UCs and those dropped by the minimal UC, the latches of the states and those
+ *       dropped by the partial states, the cubes tried by the propagation and those pushed.
+ *       The levels are measured together until they take 50 ms. A technique taking a large
+ *       share of that time for few gains, or any time for no gain, is switched off, and tried
+ *       again later, after twice as many measures each time it fails again.
+ */
+
+#ifndef AUTO_TUNE_H
+#define	AUTO_TUNE_H
+
+#include <chrono>
+#include <string>
+
+namespace car
+{
+	enum Technique {TECH_DEAD, TECH_MUC, TECH_PARTIAL, TECH_PROPAGATE, TECH_NUM};
+
+	class AutoTuner
+	{
+	public:
+		//the techniques in usable are switched on, the others are never used
+		AutoTuner (const bool usable[TECH_NUM]);
+
+		inline bool on (const Technique t) const {return on_[t];}
+		//of the tries of t at the current level, hits succeeded, in seconds
+		inline void count (const Technique t, const long long tries, const long long hits, const double seconds) {
+			tries_[t] += tries;
+			hits_[t] += hits;
+			seconds_[t] += seconds;
+		}
+		//end the current level and, once the measure is long enough, choose the techniques
+		//of the next ones. Return the switches made, empty if none
+		std::string next_level ();
+
+	private:
+		bool usable_[TECH_NUM], on_[TECH_NUM];
+		long long tries_[TECH_NUM], hits_[TECH_NUM];  //since the last decision
+		double seconds_[TECH_NUM];
+		int wait_[TECH_NUM];  //measures before t, switched off, is tried again
+		int backoff_[TECH_NUM];  //measures to wait after the next failure of t
+		bool retried_[TECH_NUM];  //t is on again after a failure, and not measured yet
+		std::chrono::steady_clock::time_point start_;  //of the levels since the last decision
+
+		void clear_counts ();
+	};
+}
+
+#endif
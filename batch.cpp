@@ -0,0 +1,205 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   batch.cpp
+ * Note: Batch mode, see batch.h. The verdict of a file is the first line of its .res
+ *       file (0 safe, 1 unsafe, 2 unknown), a worker which wrote none failed.
+ */
+
+#include "batch.h"
+#include "aigreader.h"
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdio.h>
+#include <fstream>
+#include <map>
+using namespace std;
+
+namespace car
+{
+	static const int GRACE = 10;
+	static const char* VERDICT_NAMES[BATCH_VERDICT_NUM] = {"safe", "unsafe", "unknown", "error"};
+
+	Batch::Batch (const string& output_dir, const int jobs, const int timeout) :
+	    output_dir_ (output_dir), jobs_ (jobs), timeout_ (timeout), start_ (0), time_ (0)
+	{
+		if (jobs_ <= 0)
+			jobs_ = sysconf (_SC_NPROCESSORS_ONLN);
+		if (jobs_ <= 0)
+			jobs_ = 1;
+	}
+
+	bool Batch::load (const string& list, string& error)
+	{
+		ifstream in (list.c_str ());
+		if (!in)
+		{
+			error = "can not read '" + list + "'";
+			return false;
+		}
+		map<string, string> names;
+		string line;
+		while (getline (in, line))
+		{
+			size_t b = line.find_first_not_of (" \t\r"), e = line.find_last_not_of (" \t\r");
+			if (b == string::npos || line[b] == '#')
+				continue;
+			Job job;
+			job.file = line.substr (b, e-b+1);
+			job.name = aiger_file_name (job.file);
+			//two files of the same name would write the same outputs
+			if (names.count (job.name) != 0)
+			{
+				error = "'" + job.file + "' and '" + names[job.name] + "' have the same name";
+				return false;
+			}
+			names[job.name] = job.file;
+			job.pid = 0;
+			job.start = job.time = job.cpu = 0;
+			job.mem = 0;
+			job.killed = false;
+			job.verdict = BATCH_ERROR;
+			list_.push_back (job);
+		}
+		return true;
+	}
+
+	string Batch::run ()
+	{
+		start_ = now ();
+		int running = 0;
+		for (int i = 0; i < list_.size (); i ++)
+		{
+			while (running >= jobs_)
+			{
+				if (reap ())
+					running --;
+				else
+					usleep (10000);
+			}
+			//the buffered output would be written again by the worker
+			fflush (stdout);
+			pid_t pid = fork ();
+			if (pid == 0)
+				return list_[i].file;
+			list_[i].start = now ();
+			if (pid < 0)
+			{
+				perror ("fork");
+				continue;
+			}
+			list_[i].pid = pid;
+			running ++;
+		}
+		while (running > 0)
+		{
+			if (reap ())
+				running --;
+			else
+				usleep (10000);
+		}
+		time_ = now () - start_;
+		return "";
+	}
+
+	//reap a finished worker, and kill the ones over time
+	bool Batch::reap ()
+	{
+		int status;
+		struct rusage usage;
+		pid_t pid = wait4 (-1, &status, WNOHANG, &usage);
+		if (pid <= 0)
+		{
+			if (timeout_ > 0)
+			{
+				double t = now ();
+				for (int i = 0; i < list_.size (); i ++)
+				{
+					if (list_[i].pid > 0 && !list_[i].killed && t - list_[i].start > timeout_ + GRACE)
+					{
+						kill (list_[i].pid, SIGKILL);
+						list_[i].killed = true;
+					}
+				}
+			}
+			return false;
+		}
+		for (int i = 0; i < list_.size (); i ++)
+		{
+			Job& job = list_[i];
+			if (job.pid != pid)
+				continue;
+			job.pid = 0;
+			job.time = now () - job.start;
+			job.cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+			job.mem = usage.ru_maxrss;
+			job.verdict = verdict (job, status);
+			printf ("%s %s %.2f s %.1f MB\n", job.name.c_str (), VERDICT_NAMES[job.verdict], job.time, job.mem / 1024.0);
+			fflush (stdout);
+			return true;
+		}
+		return false;
+	}
+
+	BatchVerdict Batch::verdict (const Job& job, const int status) const
+	{
+		//killed over time, or by the memory limit beyond the reserve of Resources
+		if (job.killed || WIFSIGNALED (status))
+			return BATCH_UNKNOWN;
+		ifstream in ((output_dir_ + job.name + ".res").c_str ());
+		string line;
+		if (!getline (in, line))
+			return BATCH_ERROR;
+		if (line == "0")
+			return BATCH_SAFE;
+		if (line == "1")
+			return BATCH_UNSAFE;
+		if (line == "2")
+			return BATCH_UNKNOWN;
+		return BATCH_ERROR;
+	}
+
+	void Batch::print_summary () const
+	{
+		int count[BATCH_VERDICT_NUM] = {0, 0, 0, 0};
+		double cpu = 0;
+		long mem = 0;
+		for (int i = 0; i < list_.size (); i ++)
+		{
+			count[list_[i].verdict] ++;
+			cpu += list_[i].cpu;
+			if (list_[i].mem > mem)
+				mem = list_[i].mem;
+		}
+		printf ("Batch: %d files, %d jobs\n", (int) list_.size (), jobs_);
+		for (int i = 0; i < BATCH_VERDICT_NUM; i ++)
+			printf ("Num of %s: %d\n", VERDICT_NAMES[i], count[i]);
+		printf ("Total time: %.2f s (cpu %.2f s)\n", time_, cpu);
+		printf ("Max memory of a file: %.1f MB\n", mem / 1024.0);
+	}
+
+	double Batch::now ()
+	{
+		struct timeval tv;
+		gettimeofday (&tv, NULL);
+		return tv.tv_sec + tv.tv_usec / 1000000.0;
+	}
+}
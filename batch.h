@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   batch.h
+ * Note: Batch mode (-batch), checking the AIG files of a list with a pool of workers.
+ *       A worker is a child forked from the driver after the options are parsed, which
+ *       checks one file as a plain run would, with the .res and .log files of that file
+ *       and its own -timeout and -memout. The limits and the interruption of
+ *       Resources are of the whole process, so the workers are processes rather than threads.
+ */
+
+#ifndef BATCH_H
+#define	BATCH_H
+
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+namespace car
+{
+	enum BatchVerdict {BATCH_SAFE, BATCH_UNSAFE, BATCH_UNKNOWN, BATCH_ERROR, BATCH_VERDICT_NUM};
+
+	class Batch
+	{
+	public:
+		//jobs workers at most, 0 means one per CPU. A worker running timeout+GRACE seconds
+		//without stopping by itself is killed, timeout 0 means no limit
+		Batch (const std::string& output_dir, const int jobs, const int timeout);
+
+		//read the files, one per line, return false (with error) on failure
+		bool load (const std::string& list, std::string& error);
+
+		//return the file to check in the workers, and the empty string in the driver once
+		//all the files have been checked
+		std::string run ();
+
+		//one line per file and the totals
+		void print_summary () const;
+
+	private:
+		struct Job
+		{
+			std::string file;
+			std::string name;  //of the .res and .log files
+			pid_t pid;
+			double start;
+			double time;       //wall-clock seconds
+			double cpu;        //user and system seconds
+			long mem;          //maximum resident set, KB
+			bool killed;
+			BatchVerdict verdict;
+		};
+
+		std::string output_dir_;
+		int jobs_;
+		int timeout_;
+		std::vector<Job> list_;
+		double start_, time_;
+
+		bool reap ();
+		BatchVerdict verdict (const Job& job, const int status) const;
+		static double now ();
+	};
+}
+
+#endif
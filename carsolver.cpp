@@ -18,139 +18,48 @@
 /* 
  * File:   carsolver.cpp
  * Author: Jianwen Li
- * Note: An inheritance class from Minisat::Solver for CAR use 
+ * Note: The SAT solver interface for CAR use, on top of a runtime-selected backend 
  * Created on October 4, 2017
  */
  
 #include "carsolver.h"
+#include "resource.h"
 #include <iostream>
 #include <vector>
 #include <algorithm>    //zhang xiaou add this code
 #include <fstream>      //zhang xiaou add this code
 #include <cmath>      //zhang xiaou add this code
+#include <chrono>
 using namespace std;
 
-#ifndef ENABLE_PICOSAT  
-using namespace Minisat;
-//using namespace Glucose;
-#endif
-
 namespace car
 {
- 	#ifdef ENABLE_PICOSAT
- 	int CARSolver::SAT_lit (int id) {
- 	    assert (id != 0);
- 	    while (abs (id) > picosat_variables (picosat_)) {
- 	        picosat_inc_max_var (picosat_);
- 	    }
- 	    return id;
- 	}
- 	
- 	int CARSolver::lit_id (int id) {
- 	    return id;
- 	}
- 	
- 	bool CARSolver::solve_assumption () {
- 		for (int i = 0; i < assumption_.size (); i ++) {
- 			picosat_assume (picosat_, assumption_[i]);
- 		}
- 	    int res = picosat_sat(picosat_, -1);
-        return res == PICOSAT_SATISFIABLE;
- 	}
- 	
- 	//return the model from SAT solver when it provides SAT
-	std::vector<int> CARSolver::get_model () {
-	    vector<int> res;
-	    int max_var = picosat_variables (picosat_);
-	    res.resize (max_var, 0);
-	    for (int i = 1; i < max_var; i ++) {
-	        int val = picosat_deref(picosat_, i);
-            if (val == 1)
-                res[i-1] = i;
-            else if (val == -1)
-                res[i-1] = -i;
-        }
-        
-   		return res;
+	CARSolver::CARSolver (const CARSolver& s, const bool learnts)
+	{
+		sat_ = s.sat_->clone (learnts);
+		assumption_ = s.assumption_;
+		log_ = s.log_;
+		stats_ = s.stats_;
 	}
-	
-	//return the UC from SAT solver when it provides UNSAT
- 	std::vector<int> CARSolver::get_uc () {
- 		std::vector<int> reason;
-		//if (verbose_)
-			//cout << "get uc: \n";
-		//const int *p = picosat_failed_assumptions (picosat_);
-		const int *p = picosat_mus_assumptions (picosat_, 0, NULL, 0);
-		while (*p != 0) {
-		    reason.push_back (*p);
-		    //if (verbose_)
-				//cout << *p << ", ";
-		    p++; 
-		}
- 		
-		//if (verbose_)
-			//cout << endl;
-    	return reason;
-  	}
-	
-	void CARSolver::add_clause (std::vector<int>& v) {
-	    for (int i = 0; i < v.size(); i ++) {
-            picosat_add(picosat_, v[i]);
-        }
-        picosat_add(picosat_, 0);
- 		
- 	}
- 	
- 	#else
- 	
- 	Lit CARSolver::SAT_lit (int id)
- 	{
- 		assert (id != 0);
-        int var = abs(id)-1;
-        while (var >= nVars()) newVar();
-        return ( (id > 0) ? mkLit(var) : ~mkLit(var) );
- 	}
- 	
- 	int CARSolver::lit_id (Lit l)
-    {
-    	if (sign(l)) 
-            return -(var(l) + 1);
-        else 
-            return var(l) + 1;
-    }
  	
  	bool CARSolver::solve_assumption ()
 	{
-		lbool ret = solveLimited (assumption_);
-		/*
-		if (verbose_)
+		SATStats before = stats_ != NULL ? sat_->stats () : SATStats ();
+		//throws ResourceOut instead of returning SAT_UNKNOWN
+		SATResult ret = Resources::solve (sat_, assumption_);
+		if (stats_ != NULL)
 		{
-			cout << "CARSolver::solve_assumption: assumption_ is" << endl;
-			for (int i = 0; i < assumption_.size (); i ++)
-				cout << lit_id (assumption_[i]) << ", ";
-			cout << endl;
+			SATStats after = sat_->stats ();
+			stats_->count_reused_levels (after.reused_levels - before.reused_levels);
+			stats_->count_escalations (after.escalations - before.escalations, after.escalated_unsat - before.escalated_unsat);
 		}
-		*/
-		if (ret == l_True)
-     		return true;
-   		else if (ret == l_Undef)
-     		exit (0);
-   		return false;
+		return ret == SAT_TRUE;
 	}
 	
 	//return the model from SAT solver when it provides SAT
 	std::vector<int> CARSolver::get_model ()
 	{
-		std::vector<int> res;
-		res.resize (nVars (), 0);
-   		for (int i = 0; i < nVars (); i ++)
-   		{
-     		if (model[i] == l_True)
-       			res[i] = i+1;
-     		else if (model[i] == l_False)
-       			res[i] = -(i+1);
-   		}
-   		return res;
+		return sat_->get_model ();
 	}
 	 //zhang xiaoyu code begins
 
@@ -166,18 +75,14 @@ namespace car
 	//get UC from solver
 	std::vector<int> CARSolver::get_solver_uc()
 	{
-		std::vector<int> reason;
-		if (verbose_)
-			cout << "get uc: \n";
- 		for (int k = 0; k < conflict.size(); k++) 
- 		{
-        	Lit l = conflict[k];
-        	reason.push_back (-lit_id (l));
-			if (verbose_)
-				cout << -lit_id (l) << ", ";
-    	}
-		if (verbose_)
-			cout << endl;
+		std::vector<int> reason = sat_->get_conflict ();
+		if (log_ != NULL && log_->enabled (LOG_DEBUG))
+		{
+			LogLine line (*log_, LOG_DEBUG);
+			line << "get uc: ";
+			for (int k = 0; k < reason.size (); k ++)
+				line << reason[k] << ", ";
+		}
     	return reason;
 	}
     //count_main_solver_SAT_time_end 
@@ -196,9 +101,9 @@ namespace car
 			std::vector<int> temp_assumption;
 			for(int i=0;i<assumption_.size();i++)
 			{
-				//if(i == int(assumption_.size()*sat_times/max_sat_time)) pop_element = lit_id(assumption_[i]);
-				if(i == 0) pop_element = lit_id(assumption_[i]);
-				else temp_assumption.push_back(lit_id(assumption_[i]));
+				//if(i == int(assumption_.size()*sat_times/max_sat_time)) pop_element = assumption_[i];
+				if(i == 0) pop_element = assumption_[i];
+				else temp_assumption.push_back(assumption_[i]);
 			}
 			clear_assumption();
 			update_assumption(temp_assumption);
@@ -234,53 +139,35 @@ namespace car
         update_assumption(mus);
 		for (int i = 0; i < assumption_.size(); i++)
 		{
-			mus_reason.push_back(lit_id (assumption_[i]));
+			mus_reason.push_back(assumption_[i]);
 		}
         return mus_reason;   
 	}
 	//return the UC from SAT solver when it provides UNSAT
  	std::vector<int> CARSolver::get_uc (bool minimal)
  	{
- 		std::vector<int> reason;
-		//if (verbose_)
-			//cout << "get uc: \n";
- 		for (int k = 0; k < conflict.size(); k++) 
- 		{
-        	Lit l = conflict[k];
-        	reason.push_back (-lit_id (l));
-			//if (verbose_)
-				//cout << -lit_id (l) << ", ";
-    	}
-		//if (verbose_)
-			//cout << endl;
-		if(minimal) return get_mus(reason);
-    	else return reason;
+ 		std::vector<int> reason = sat_->get_conflict ();
+		if (!minimal)
+			return reason;
+		if (stats_ == NULL)
+			return get_mus (reason);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+		std::vector<int> mus = get_mus (reason);
+		stats_->count_minimal_uc_time (std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ());
+		stats_->count_orig_uc_size (int (reason.size ()));
+		stats_->count_reduce_uc_size (int (mus.size ()));
+		return mus;
   	}
 	
 	void CARSolver::add_clause (std::vector<int>& v)
  	{
- 		vec<Lit> lits;
- 		for (std::vector<int>::iterator it = v.begin (); it != v.end (); it ++)
- 			lits.push (SAT_lit (*it));
- 		/*
- 		if (verbose_)
- 		{
- 			cout << "Adding clause " << endl << "(";
- 			for (int i = 0; i < lits.size (); i ++)
- 				cout << lit_id (lits[i]) << ", ";
- 			cout << ")" << endl;
- 			cout << "Before adding, size of clauses is " << clauses.size () << endl;
- 		}
- 		*/
- 		bool res = addClause (lits);
+ 		bool res = sat_->add_clause (v);
  		
- 		if (!res && verbose_)
- 			cout << "Warning: Adding clause does not success\n";
+ 		if (!res && log_ != NULL)
+ 			LogLine (*log_, LOG_DEBUG) << "Warning: Adding clause does not success";
  		
  	}
  	
- 	#endif
- 	
  	void CARSolver::add_clause (int id)
  	{
  		std::vector<int> v;
@@ -331,23 +218,14 @@ namespace car
  	
  	void CARSolver::print_clauses ()
 	{
-		#ifndef ENABLE_PICOSAT
-		cout << "clauses in SAT solver: \n";
-		for (int i = 0; i < clauses.size (); i ++)
-		{
-			Clause& c = ca[clauses[i]];
-			for (int j = 0; j < c.size (); j ++)
-				cout << lit_id (c[j]) << " ";
-			cout << "0 " << endl;
-		}
-		#endif
+		sat_->print_clauses ();
 	}
 	
 	void CARSolver::print_assumption ()
 	{
 	    cout << "assumptions in SAT solver: \n";
 	    for (int i = 0; i < assumption_.size (); i ++)
-	        cout << lit_id (assumption_[i]) << " ";
+	        cout << assumption_[i] << " ";
 	    cout << endl;
 	}
 	
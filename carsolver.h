@@ -18,52 +18,50 @@
 /* 
  * File:   carsolver.h
  * Author: Jianwen Li
- * Note: An inheritance class from Minisat::Solver for CAR use 
+ * Note: The SAT solver interface for CAR use, on top of a runtime-selected backend 
  * Created on October 4, 2017
  */
  
 #ifndef CAR_SOLVER_H
 #define	CAR_SOLVER_H
 
-#ifdef ENABLE_PICOSAT
-extern "C" {
-#include "picosat/picosat.h"
-}
-#else
-#include "minisat/core/Solver.h"
-//#include "glucose/core/Solver.h"
-#endif
-
+#include "satsolver.h"
 #include "statistics.h"  //zhang xiaoyu made this change
+#include "logger.h"
 #include <vector>
 #include <assert.h>
 #include <fstream>      //zhang xiaou add this code
 
 namespace car
 {
-    #ifdef ENABLE_PICOSAT
-    class CARSolver 
-    #else
-	class CARSolver : public Minisat::Solver //Glucose:Solver
-	#endif
+	class CARSolver
 	{
 	public:
-	    #ifdef ENABLE_PICOSAT
-	    CARSolver () { picosat_ = picosat_init(); }
-		CARSolver (bool verbose) : verbose_ (verbose) { picosat_reset(picosat_); } 
-	    #else
-		CARSolver () {}
-		CARSolver (bool verbose) : verbose_ (verbose) {} 
-		#endif
+		CARSolver (const SATBackend backend = BACKEND_MINISAT) : log_ (NULL), stats_ (NULL), sat_ (new_sat_solver (backend)) {}
+		CARSolver (Logger* log, const SATBackend backend = BACKEND_MINISAT) : log_ (log), stats_ (NULL), sat_ (new_sat_solver (backend)) {} 
+		CARSolver (const CARSolver& s, const bool learnts);
+		virtual ~CARSolver () {delete sat_;}
+		
+		//copy the clause database, watches and level-0 units into a new solver, 
+		//learnt clauses are copied only if learnts is true
+		virtual CARSolver* clone (const bool learnts = false) const {return new CARSolver (*this, learnts);}
+		
+		inline SATBackend backend () const {return sat_->backend ();}
+		
+		//queries exceeding conflicts are escalated to Glucose's parallel MultiSolvers
+		inline void enable_parallel (const long long conflicts, const int threads) {
+			sat_ = new_parallel_sat_solver (sat_, conflicts, threads);
+		}
 		
-		bool verbose_;
+		//preferred values of the next decisions, see SATSolver::set_phase
+		inline void set_phase (const std::vector<int>& lits) {sat_->set_phase (lits);}
+		inline SATStats sat_stats () const {return sat_->stats ();}
+		//make the running (or next) solve call, made by another thread, return unknown
+		inline void interrupt () {sat_->interrupt ();}
 		
-		#ifdef ENABLE_PICOSAT
-		std::vector<int> assumption_;
-		#else
-		Minisat::vec<Minisat::Lit> assumption_;  //Assumption for SAT solver
-		//Glucose::vec<Glucose::Lit> assumption_;  //Assumption for SAT solver     
-		#endif
+		Logger* log_;  //for the trace of the SAT calls (LOG_DEBUG), NULL for none
+		
+		std::vector<int> assumption_;  //Assumption for SAT solver
 		Statistics* stats_;   //zhang xiaoyu made this change
 		//functions
 		bool solve_assumption ();
@@ -84,35 +82,12 @@ namespace car
  		void add_clause (int, int, int, int);
  		void add_clause (std::vector<int>&);
  	
- 	    #ifdef ENABLE_PICOSAT
- 	    int SAT_lit (int id); //create the Lit used in PicoSat SAT solver for the id.
- 		int lit_id (int);  //return the id of SAT lit
- 	    #else
- 		Minisat::Lit SAT_lit (int id); //create the Lit used in SAT solver for the id.
- 		int lit_id (Minisat::Lit);  //return the id of SAT lit
- 		
- 		//Glucose::Lit SAT_lit (int id); //create the Lit used in SAT solver for the id.
- 		//int lit_id (Glucose::Lit);  //return the id of SAT lit
- 		#endif
- 		
  		//inline int size () {return clauses.size ();}
  		inline void clear_assumption () {assumption_.clear ();}
  		
- 		inline void assumption_push (int id) {
- 			#ifdef ENABLE_PICOSAT
- 			assumption_.push_back (id);
- 			#else
- 			assumption_.push (SAT_lit (id));
- 			#endif
- 		}
+ 		inline void assumption_push (int id) {assumption_.push_back (id);}
  		
- 		inline void assumption_pop () {
- 			#ifdef ENABLE_PICOSAT
- 			assumption_.pop_back ();
- 			#else
- 			assumption_.pop ();
- 			#endif
- 		}
+ 		inline void assumption_pop () {assumption_.pop_back ();}
  		
  		//printers
  		void print_clauses ();
@@ -141,10 +116,8 @@ namespace car
  			add_clause (-l, r3);
  			add_clause (l, -r1, -r2, -r3);
  		}
- 	#ifdef ENABLE_PICOSAT
- 	private:
- 	   PicoSAT* picosat_;
- 	#endif
+ 	protected:
+ 		SATSolver* sat_;  //the backend, chosen at construction
 	};
 }
 
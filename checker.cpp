@@ -25,13 +25,16 @@
 #include <iostream>
 #include "utility.h"
 #include "statistics.h"
+#include "resource.h"
+#include <new>
+#include <algorithm>
 using namespace std;
 
 namespace car
 {
     ///////////////////////////////////main functions//////////////////////////////////
-    bool Checker::check (std::ofstream& out){
-	    for (int i = 0; i < model_->num_outputs (); i ++){
+    bool Checker::check (std::ostream& out){
+	    for (int i = property_; i < model_->num_outputs (); i ++){
 	        bad_ = model_->output (i);
 	        
 	        //for the particular case when bad_ is true or false
@@ -47,23 +50,34 @@ namespace car
 	        	    out << endl;
 	        	}
 	        	out << "." << endl;
-	        	if (verbose_){
-	        		cout << "return SAT since the output is true" << endl;
-	        	}
+	        	LogLine (log_, LOG_DEBUG) << "return SAT since the output is true";
+	        	log_.flush ();
 	        	return true;
 	        }
 	        else if (bad_ == model_->false_id ()){
 	        	out << "0" << endl;
 	        	out << "b" << endl;
 	        	out << "." << endl;
-	        	if (verbose_){
-	        		cout << "return UNSAT since the output is false" << endl;
-	        	}
+	        	LogLine (log_, LOG_DEBUG) << "return UNSAT since the output is false";
+	        	log_.flush ();
 	        	return false;
 	        }
 	        
-	        car_initialization ();
-	        bool res = car_check ();
+	        bool res;
+	        try {
+	        	car_initialization ();
+	        	res = car_check ();
+	        }
+	        catch (ResourceOut& e) {
+	        	report_unknown (out, i, e.what ());
+	        	return false;
+	        }
+	        catch (std::bad_alloc& e) {
+	        	report_unknown (out, i, "memory limit");
+	        	return false;
+	        }
+	        if (!cache_dir_.empty ())
+	        	save_cache (!res);
 	        if (res)
     			out << "1" << endl;
    			else
@@ -73,48 +87,131 @@ namespace car
     			print_evidence (out);
     		out << "." << endl;
 	        car_finalization ();
+	        log_.flush ();
 	        return res;
 	    }
 	}
 	
+	//a budget is exhausted: release the solvers and states (the memory may be short) and report UNKNOWN
+	void Checker::report_unknown (std::ostream& out, const int i, const char* reason)
+	{
+		LogLine (log_, LOG_INFO) << "Last Frame";
+		print_frames_sizes ();
+		LogLine (log_, LOG_INFO) << "frame_ size:" << frame_size ();
+		car_finalization ();
+		delete_inv_solver ();
+		out << "2" << endl;
+		out << "b" << i << endl;
+		out << "." << endl;
+		LogLine (log_, LOG_INFO) << "return UNKNOWN: " << reason;
+		log_.flush ();
+	}
+	
+	//the minimal UCs are measured by the solvers, in stats_
+	void Checker::tune (const int frame_level)
+	{
+		long long orig = stats_->orig_uc_size (), reduce = stats_->reduce_uc_size ();
+		double seconds = stats_->minimal_uc_time ();
+		tuner_->count (TECH_MUC, orig - tuned_orig_uc_, (orig - reduce) - (tuned_orig_uc_ - tuned_reduce_uc_), seconds - tuned_uc_time_);
+		tuned_orig_uc_ = orig;
+		tuned_reduce_uc_ = reduce;
+		tuned_uc_time_ = seconds;
+		
+		std::string changes = tuner_->next_level ();
+		if (!changes.empty ())
+			LogLine (log_, LOG_FRAMES) << "auto at frame " << frame_level << ": " << changes;
+		dead_ = tuner_->on (TECH_DEAD);
+		minimal_uc_ = tuner_->on (TECH_MUC);
+		partial_state_ = tuner_->on (TECH_PARTIAL);
+		propagate_ = tuner_->on (TECH_PROPAGATE);
+	}
+	
+	//LOG_FRAMES: the frames whose size changed since the last level, LOG_INFO: all the sizes,
+	//at most once a second
+	void Checker::report_frames (const int frame_level)
+	{
+		if (log_.enabled (LOG_FRAMES))
+		{
+			LogLine line (log_, LOG_FRAMES);
+			line << "Frame " << frame_level << ":";
+			reported_sizes_.resize (F_.size (), -1);
+			for (int i = 0; i < F_.size (); i ++)
+			{
+				if (reported_sizes_[i] == F_[i].size ())
+					continue;
+				line << " F" << i << "=" << F_[i].size ();
+				reported_sizes_[i] = F_[i].size ();
+			}
+		}
+		else if (log_.enabled (LOG_INFO))
+		{
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now ();
+			if (now - reported_ < std::chrono::seconds (1))
+				return;
+			reported_ = now;
+			LogLine (log_, LOG_INFO) << "Frame " << frame_level;
+			print_frames_sizes ();
+		}
+	}
+	
 	bool Checker::car_check (){
-		if (verbose_)
-			cout << "start check ..." << endl;
+		LogLine (log_, LOG_DEBUG) << "start check ...";
 		if (immediate_satisfiable ()){
-			if (verbose_)
-				cout << "return SAT from immediate_satisfiable" << endl;
+			LogLine (log_, LOG_DEBUG) << "return SAT from immediate_satisfiable";
 			return true;
 		}
 
 		initialize_sequences ();
 			
+		if (!cache_dir_.empty () && resume_file_.empty () && load_cache ()){
+			LogLine (log_, LOG_DEBUG) << "return UNSAT from the cached invariant";
+			return false;
+		}
+			
 		int frame_level = 0;
+		if (!checkpoint_file_.empty () || !resume_file_.empty ())
+			frame_level = start_checkpoint ();
 		while (true){
-		    cout << "Frame " << frame_level << endl;
-		    //print the number of clauses in each frame
-		    for (int i = 0; i < F_.size (); i ++) {
-		    	cout << F_[i].size () << " ";
-		    }
-		    cout << endl;
-		    //end of print
+			iteration_ ++;
+			if (checkpoint_ != NULL)
+				checkpoint_->commit (frame_level, cubes_, cube_);
+		    report_frames (frame_level);
+		    
+		    //frame_ only keeps cubes of the new level if they were propagated
+		    bool propagated = propagate_;
+		    if (tuner_ != NULL)
+		    	tune (frame_level);
+		    if (propagate_ && !propagated)
+		    	clear_frame ();
 		    
 		    //handle the special start states
 			reset_start_solver ();
 			if (!propagate_)
 		    	clear_frame ();
 			minimal_update_level_ = F_.size () - 1;
+			if (!seeds_.empty ())
+				seed_frame ();
+			if (lemmas_ != NULL)
+				import_lemmas ();
 			if (try_satisfy (frame_level)){
-				if (verbose_)
-					cout << "return SAT from try_satisfy at frame level " << frame_level << endl;
+				LogLine (log_, LOG_DEBUG) << "return SAT from try_satisfy at frame level " << frame_level;
 				return true;
 			}
 			//it is true when some reason returned from Main solver is empty
 			if (safe_reported ()){
-				if (verbose_)
-					cout << "return UNSAT from safe reported" << endl;
+				LogLine (log_, LOG_DEBUG) << "return UNSAT from safe reported";
 				return false;
 			}
 			extend_F_sequence ();
+			if (lemmas_ != NULL){
+				const Frame& frame = F_.back ();
+				for (int i = 0; i < frame.size (); ++ i)
+					export_lemma (frame[i]);
+			}
+			if (compact_ms_ > 0)
+				compact_frames ();
+			if (evict_age_ > 0)
+				evict_frames ();
 			
 			if (propagate_){
 				clear_frame ();
@@ -125,8 +222,8 @@ namespace car
 			frame_level ++;
 			
 			if (invariant_found (frame_level+1)){
-				if (verbose_){
-					cout << "return UNSAT from invariant found at frame " << F_.size ()-1 << endl;
+				if (log_.enabled (LOG_DEBUG)){
+					LogLine (log_, LOG_DEBUG) << "return UNSAT from invariant found at frame " << F_.size ()-1;
 					print ();	
 				}
 				return false;
@@ -134,13 +231,210 @@ namespace car
 			
 			
 		}
-		if (verbose_)
-			cout << "end of check" << endl;
+		LogLine (log_, LOG_DEBUG) << "end of check";
+		return false;
+	}
+	
+	//replay the log of resume_file_ (the solvers are rebuilt by the replay) and open the
+	//log of checkpoint_file_, return the frame level to continue from
+	int Checker::start_checkpoint ()
+	{
+		//the dead checks of forward CAR depend on the states explored so far, so B_ is logged
+		CheckpointLog* log = new CheckpointLog (model_, bad_, forward_, forward_ && dead_);
+		int frame_level = 0;
+		std::string prefix;
+		if (!resume_file_.empty ()){
+			std::vector<CheckpointEvent> events;
+			if (log->load (resume_file_, events, frame_level, prefix)){
+				//replayed through the log, so that it knows the states and cubes_ of the prefix
+				checkpoint_ = log;
+				replay (events);
+				checkpoint_ = NULL;
+				LogLine (log_, LOG_INFO) << "resume from frame " << frame_level << " of " << resume_file_;
+			}
+			else{
+				LogLine (log_, LOG_INFO) << "cannot resume from " << resume_file_ << ", start from frame 0";
+				frame_level = 0;
+				prefix.clear ();
+			}
+		}
+		if (!checkpoint_file_.empty () && log->open (checkpoint_file_, prefix))
+			checkpoint_ = log;
+		else{
+			if (!checkpoint_file_.empty ())
+				LogLine (log_, LOG_INFO) << "cannot open the checkpoint " << checkpoint_file_;
+			delete log;
+		}
+		return frame_level;
+	}
+	
+	void Checker::replay (const std::vector<CheckpointEvent>& events)
+	{
+		std::vector<State*> states;
+		for (int i = 0; i < events.size (); i ++){
+			const CheckpointEvent& e = events[i];
+			Cube cu = e.cube;
+			switch (e.tag){
+				case CKPT_CUBE:
+					push_to_frame (cu, e.level);
+					break;
+				case CKPT_FRAME:
+					comm_ = cu;
+					extend_F_sequence ();
+					break;
+				case CKPT_CLEAR:
+					clear_frame ();
+					break;
+				case CKPT_DEAD:
+					add_dead_to_solvers (cu);
+					break;
+				case CKPT_STATE:{
+					State* pre = (e.level > 0 && e.level <= states.size ()) ? states[e.level-1] : NULL;
+					Cube::iterator sep = std::find (cu.begin (), cu.end (), 0);
+					Cube inputs (cu.begin (), sep), latches (sep+1, cu.end ());
+					State* s = new State (&state_context_, pre, inputs, latches, forward_, pre == NULL);
+					update_B_sequence (s);
+					states.push_back (s);
+					break;
+				}
+				case CKPT_KILL:
+					if (e.level > 0 && e.level <= states.size ())
+						states[e.level-1]->mark_dead ();
+					break;
+				case CKPT_ALIVE:
+					dead_solver_->CARSolver::add_clause_from_cube (cu);
+					if (e.level > 0 && e.level <= states.size ())
+						states[e.level-1]->set_added_to_dead_solver (true);
+					break;
+				case CKPT_CUBES:
+					if (e.level < cubes_.size ())
+						cubes_[e.level] = cu;
+					else
+						cube_ = cu;
+					break;
+				case CKPT_COMMIT:
+					//the start of a frame, the last one is done by car_check
+					if (i+1 < events.size ())
+						reset_start_solver ();
+					break;
+			}
+		}
+	}
+	
+	//an exact match of a safe run only needs its invariant to be checked again, return true if it holds.
+	//Otherwise the cached cubes are seeded into the frames (seed_frame)
+	bool Checker::load_cache ()
+	{
+		FrameCache cache (cache_dir_, design_hash_, model_, bad_, forward_);
+		std::vector<Frame> frames;
+		std::vector<Cube> deads;
+		bool safe;
+		CacheMatch match = cache.load (frames, deads, safe);
+		if (match == CACHE_NONE)
+			return false;
+		int num = 0;
+		for (int i = 0; i < frames.size (); i ++)
+			num += frames[i].size ();
+		stats_->count_cache_cubes (num);
+		LogLine (log_, LOG_INFO) << "warm start from the " << (match == CACHE_EXACT ? "exact" : "near") << " match " << cache.file ();
+		if (match == CACHE_EXACT && safe && cached_invariant (frames, deads)){
+			F_ = frames;
+			deads_.assign (deads);
+			return true;
+		}
+		seeds_ = frames;
 		return false;
 	}
 	
+	//one InvSolver query: the last frame is in the union of the others
+	bool Checker::cached_invariant (const std::vector<Frame>& frames, std::vector<Cube>& deads)
+	{
+		DeadStore current;
+		current.swap (deads_);
+		deads_.assign (deads);
+		create_inv_solver ();
+		deads_.swap (current);
+		for (int i = 0; i+1 < frames.size (); i ++)
+			inv_solver_->add_constraint_or (frames[i], forward_);
+		inv_solver_->add_constraint_and (frames.back (), forward_);
+		stats_->count_inv_solver_SAT_time_start ();
+		bool res = !inv_solver_->solve_with_assumption ();
+		stats_->count_inv_solver_SAT_time_end ();
+		delete_inv_solver ();
+		return res;
+	}
+	
+	//add the cached cubes of the level of frame_ which still hold for this transition relation,
+	//that is which contain no successor (predecessor for backward) of F_[level-1], nor initial state
+	void Checker::seed_frame ()
+	{
+		int level = F_.size ();
+		if (level >= seeds_.size ()){
+			seeds_.clear ();
+			return;
+		}
+		Frame& seeds = seeds_[level];
+		for (int i = 0; i < seeds.size (); i ++){
+			Cube& cu = seeds[i];
+			if (forward_ && is_initial (cu))
+				continue;
+			if (!propagate (cu, level-1))
+				continue;
+			stats_->count_cache_seeded ();
+			push_to_frame (cu, level);
+			if (forward_){
+				for (int j = level-1; j >= 1; --j)
+					push_to_frame (cu, j);
+			}
+		}
+		seeds.clear ();
+	}
+	
+	//each cube is sent once, the other runs check it against their own frames
+	void Checker::export_lemma (const Cube& cu)
+	{
+		if (!exported_.insert (cu).second)
+			return;
+		if (lemmas_->push (lemma_member_, cu))
+			stats_->count_lemma_exported ();
+	}
+	
+	//the lemmas of the other runs of -portfolio are tried once, at the new frame level, as
+	//seed_frame checks the cubes of the cache
+	void Checker::import_lemmas ()
+	{
+		Cube cu;
+		int level = F_.size ();
+		while (lemmas_->pop (lemma_member_, cu)){
+			if (forward_ && is_initial (cu))
+				continue;
+			if (!propagate (cu, level-1))
+				continue;
+			stats_->count_lemma_imported ();
+			add_uc (cu, level);
+		}
+	}
+	
+	void Checker::save_cache (const bool safe)
+	{
+		if (F_.empty ())  //decided before the frames
+			return;
+		FrameCache cache (cache_dir_, design_hash_, model_, bad_, forward_);
+		std::vector<Frame> frames (F_.size ());
+		for (int i = 0; i < F_.size (); i ++)
+			frames[i] = frame_with_archive (i, frames[i]);
+		if (!cache.save (frames, deads_.cubes (), safe))
+			LogLine (log_, LOG_INFO) << "cannot write the cache " << cache.file ();
+	}
+	
 	bool Checker::try_satisfy (const int frame_level)
 	{
+		if (spec_workers_ > 0){
+			if (speculate (frame_level))
+				return true;
+			if (safe_reported ())
+				return false;
+		}
 		
 		int res = do_search (frame_level);
 		if (res == 1)
@@ -226,6 +520,232 @@ namespace car
 		return -1;
 	}
 	
+	/*Speculative search of -spec on the states of B_
+	* The workers run the search of try_satisfy_by from the states of B_ at frame_level, each
+	* on a clone of solver_, with full states and without dead states. The UCs they find are
+	* then added to the frames, so that do_search mostly finds the states blocked, and the
+	* states they find are added to B_.
+	* Output:
+	*       true: a counterexample is found
+	*/
+	bool Checker::speculate (const int frame_level)
+	{
+		//the partial states of -partial are left to do_search
+		vector<State*> states;
+		for (int i = B_.size () - 1; i >= 0; -- i)
+			for (int j = 0; j < B_[i].size (); ++ j)
+				if (full_state (B_[i][j]) && !tried_before (B_[i][j], frame_level+1))
+					states.push_back (B_[i][j]);
+		//too few states to share
+		if (int (states.size ()) < spec_workers_)
+			return false;
+		
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+		SpecPool pool (spec_workers_);
+		vector<MainSolver*> solvers;
+		for (int i = 0; i < spec_workers_; ++ i){
+			solvers.push_back (solver_->clone ());
+			solvers.back ()->stats_ = NULL;  //Statistics is not shared between threads
+			pool.set_solver (i, solvers.back ());
+		}
+		//the workers take their newest task first, so each starts from its first state as do_search
+		for (int i = int (states.size ()) - 1; i >= 0; -- i){
+			SpecNode* n = pool.new_node (0);
+			n->latches = states[i]->s ();
+			n->parent = NULL;
+			n->state = states[i];
+			SpecTask t = {n, frame_level, false};
+			pool.push (i % spec_workers_, t);
+		}
+		int top = F_.size ();
+		try {
+			pool.run ([&] (int worker) {spec_work (pool, worker, solvers[worker], top);});
+		}
+		catch (...) {
+			for (int i = 0; i < solvers.size (); ++ i)
+				delete solvers[i];
+			throw;
+		}
+		for (int i = 0; i < solvers.size (); ++ i)
+			delete solvers[i];
+		
+		const vector<SpecUC>& ucs = pool.ucs ();
+		for (int i = 0; i < ucs.size (); ++ i){
+			Cube cu = ucs[i].cu;
+			if (cu.empty ()){
+				report_safe ();
+				break;
+			}
+			add_uc (cu, ucs[i].level);
+		}
+		stats_->count_speculation (ucs.size (), std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ());
+		LogLine (log_, LOG_DEBUG) << "speculation at frame " << frame_level << ": " << states.size () << " states, " << ucs.size () << " UCs";
+		if (safe_reported ())
+			return false;
+		if (pool.counterexample () != NULL){
+			bool res = immediate_satisfiable (spec_state (pool.counterexample ()));
+			assert (res);
+			return res;
+		}
+		//the found states are in B_ for the next frames, as try_satisfy_by adds them
+		for (int i = 0; i < spec_workers_; ++ i){
+			deque<SpecNode>& nodes = pool.nodes (i);
+			for (int j = 0; j < nodes.size (); ++ j)
+				spec_state (&nodes[j]);
+		}
+		return false;
+	}
+	
+	void Checker::spec_work (SpecPool& pool, const int worker, MainSolver* solver, const int top)
+	{
+		size_t next = 0;
+		vector<SpecUC> ucs;
+		Fsequence found;  //the published UCs, as the frames of F_ they go to
+		SpecTask t;
+		while (pool.pop (worker, t)){
+			try {
+				ucs.clear ();
+				pool.fetch (next, ucs);
+				for (int i = 0; i < ucs.size (); ++ i){
+					//as push_to_frame does, the frames from top on are not in the solvers
+					int lowest = forward_ ? 1 : ucs[i].level;
+					for (int l = ucs[i].level; l >= lowest; -- l){
+						if (l < top)
+							solver->add_clause_from_cube (ucs[i].cu, l, forward_);
+						if (l >= found.size ())
+							found.resize (l+1);
+						found[l].push_back (ucs[i].cu);
+					}
+				}
+				spec_step (pool, worker, solver, t, top, found);
+			}
+			catch (ResourceOut& e) {
+				//a query over the SAT budgets only drops its task
+				if (Resources::interrupted ())
+					throw;
+				if (pool.stopped ())
+					return;
+			}
+			pool.done ();
+		}
+	}
+	
+	//one query of try_satisfy_by: a new state is tried before the node is tried again, a blocked
+	//node is tried at the next frame. The frames are read, as the main thread waits
+	void Checker::spec_step (SpecPool& pool, const int worker, MainSolver* solver, SpecTask t, const int top,
+	                         const Fsequence& found)
+	{
+		SpecNode* n = t.node;
+		while (spec_blocked (n->latches, t.level+1, found)){
+			if (!t.again || ++ t.level >= top)
+				return;
+		}
+		Assignment assumption = n->latches;
+		spec_priority (assumption, t.level, found);
+		solver->set_assumption (assumption, t.level, forward_);
+		if (!solver->solve_with_assumption ()){
+			bool constraint = false;
+			Cube cu = solver->get_conflict (forward_, minimal_uc_, constraint);
+			state_uc (cu, n->latches);
+			SpecUC u = {cu, t.level+1};
+			pool.publish (u);
+			if (cu.empty ())
+				pool.stop ();
+			else if (t.level+1 < top){
+				SpecTask next = {n, t.level+1, false};
+				pool.push (worker, next);
+			}
+			return;
+		}
+		
+		Assignment st = solver->get_state (forward_, false);
+		SpecNode* c = pool.new_node (worker);
+		c->inputs = model_->shrink_to_input_vars (st);
+		c->latches = state_pair (st).second;
+		c->parent = n;
+		c->state = NULL;
+		int level = spec_level (c->latches, t.level, found);
+		if (level == -1){
+			//c is at level -1, as for immediate_satisfiable (s)
+			if (forward_ || solver->solve_with_assumption (c->latches, bad_)){
+				pool.found (c);
+				return;
+			}
+			bool constraint = false;
+			Cube cu = solver->get_conflict (forward_, minimal_uc_, constraint);
+			state_uc (cu, c->latches);
+			SpecUC u = {cu, 0};
+			pool.publish (u);
+			if (cu.empty ()){
+				pool.stop ();
+				return;
+			}
+		}
+		SpecTask again = {n, t.level, true};
+		pool.push (worker, again);
+		SpecTask next = {c, level == -1 ? 0 : level, false};
+		pool.push (worker, next);
+	}
+	
+	//tried_before and get_new_level for the full states of the workers, on the frames and the
+	//UCs found so far, without side effects
+	bool Checker::spec_blocked (const Cube& st, const int frame_level, const Fsequence& found)
+	{
+		const Frame& frame = (frame_level < F_.size ()) ? F_[frame_level] : frame_;
+		for (int i = 0; i < frame.size (); ++ i)
+			if (spec_imply (st, frame[i]))
+				return true;
+		if (frame_level < found.size ())
+			for (int i = 0; i < found[frame_level].size (); ++ i)
+				if (spec_imply (st, found[frame_level][i]))
+					return true;
+		return false;
+	}
+	
+	//get_priority of -inter, on the last UC found at frame_level+1
+	void Checker::spec_priority (Assignment& st, const int frame_level, const Fsequence& found)
+	{
+		if (!inter_)
+			return;
+		const Cube* cu = NULL;
+		if (frame_level+1 < found.size () && !found[frame_level+1].empty ())
+			cu = &found[frame_level+1].back ();
+		else{
+			const Frame& frame = (frame_level+1 < F_.size ()) ? F_[frame_level+1] : frame_;
+			if (frame.empty ())
+				return;
+			cu = &frame.back ();
+		}
+		std::vector<int> prefix;
+		if (forward_)
+			prefix = car::cube_intersect (*cu, st);
+		else{
+			for (int i = 0; i < cu->size (); ++ i)
+				if (st[abs ((*cu)[i]) - model_->num_inputs () - 1] == (*cu)[i])
+					prefix.push_back ((*cu)[i]);
+		}
+		st.insert (st.begin (), prefix.begin (), prefix.end ());
+	}
+	
+	int Checker::spec_level (const Cube& st, const int frame_level, const Fsequence& found)
+	{
+		for (int i = 0; i < frame_level; ++ i)
+			if (!spec_blocked (st, i, found))
+				return i-1;
+		return frame_level - 1;
+	}
+	
+	//the state of n in B_, made after the one of its parent as try_satisfy_by does
+	State* Checker::spec_state (SpecNode* n)
+	{
+		if (n->state == NULL){
+			State* parent = spec_state (n->parent);
+			n->state = new State (&state_context_, parent, n->inputs, n->latches, forward_);
+			update_B_sequence (n->state);
+		}
+		return n->state;
+	}
+	
 	bool Checker::try_satisfy_by (int frame_level, State* s)
 	{
 		if (tried_before (s, frame_level+1))
@@ -288,10 +808,15 @@ namespace car
 		
 		if (forward_ && dead_ && all_predeccessor_dead){
 			Cube dead_uc;
-			if (is_dead (s, dead_uc)){
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+			bool dead = is_dead (s, dead_uc);
+			count_tuned (TECH_DEAD, start, 1, dead ? 1 : 0);
+			if (dead){
 				//cout << "dead: " << endl;
 				//car::print (dead_uc);
 				s->mark_dead ();
+				if (checkpoint_ != NULL)
+					checkpoint_->mark_dead (s);
 				add_dead_to_solvers (dead_uc);
 				//if (car::imply (cu, dead_uc))
 				return false;
@@ -330,36 +855,171 @@ namespace car
 	
 	bool Checker::propagate (int n){
 		assert (n >= 0 && n < F_.size());
+		frame_gens_.resize (F_.size (), 0);
+		propagated_gens_.resize (F_.size (), -1);
+		propagated_constraints_.resize (F_.size (), -1);
+		//the query of a cube depends on the clauses of F_[n] and on the constraints of solver_
+		//(the dead cubes), if neither changed since the last propagation of F_[n], the cubes
+		//which were not pushed still cannot be
+		if (propagated_gens_[n] == frame_gens_[n] && propagated_constraints_[n] == constraint_gen_)
+			return false;
 		Frame& frame = F_[n];
 		Frame& next_frame = (n+1 >= F_.size()) ? frame_ : F_[n+1];
+		hash_set<Cube, CubeHash> next (next_frame.begin (), next_frame.end ());
 		
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+		int tried = 0, pushed = 0;
 		bool flag = true;
 		for (int i = 0; i < frame.size (); ++i){
 			Cube& cu = frame[i];
-			
-			
-			bool propagated = false;
-			for (int j = 0; j < next_frame.size(); ++j){
-				if (car::imply (cu, next_frame[j]) && car::imply (next_frame[j], cu)){
-					propagated = true;
-					break;
-				}
-			}
-			if (propagated) continue;
-			
+			if (next.find (cu) != next.end ())
+				continue;
 	
+			tried ++;
 		    if (propagate (cu, n)){
 		    	push_to_frame (cu, n+1);
+		    	pushed ++;
 		    }
 		    else
 		    	flag = false;
 		}
+		count_tuned (TECH_PROPAGATE, start, tried, pushed);
+		propagated_gens_[n] = frame_gens_[n];
+		propagated_constraints_[n] = constraint_gen_;
+		//the evicted cubes of F_[n] may not be in the next frame
+		if (n < archive_.size () && !archive_[n].empty ())
+			flag = false;
 		
 		if (flag)
 			return true;
 		return false;
 	}
 	
+	//frames 0 and the top one are kept whole
+	void Checker::evict_frames ()
+	{
+		if (last_used_.size () < F_.size ())
+			last_used_.resize (F_.size ());
+		archive_.resize (F_.size ());
+		int evicted = 0;
+		for (int i = 1; i+1 < F_.size (); i ++){
+			hash_map<Cube, int, CubeHash>& used = last_used_[i];
+			hash_map<Cube, int, CubeHash> kept_used;
+			Frame kept;
+			for (int j = 0; j < F_[i].size (); j ++){
+				Cube& cu = F_[i][j];
+				auto it = used.find (cu);
+				//a cube not added by push_to_frame (the first frames, a cache) starts now
+				int t = (it == used.end ()) ? iteration_ : it->second;
+				if (iteration_ - t >= evict_age_)
+					archive_[i].push_back (cu);
+				else{
+					kept.push_back (cu);
+					kept_used[cu] = t;
+				}
+			}
+			used.swap (kept_used);
+			if (kept.size () == F_[i].size ())
+				continue;
+			evicted += F_[i].size () - kept.size ();
+			F_[i].swap (kept);
+			solver_->reset_frame (F_[i], i, forward_);
+		}
+		stats_->count_evicted (evicted);
+	}
+	
+	//F_[level] with its evicted cubes, in tmp if there are any
+	const Frame& Checker::frame_with_archive (const int level, Frame& tmp)
+	{
+		if (level >= archive_.size () || archive_[level].empty ())
+			return F_[level];
+		tmp = F_[level];
+		tmp.insert (tmp.end (), archive_[level].begin (), archive_[level].end ());
+		return tmp;
+	}
+	
+	//the frames changed since their last compaction, from the top one down, until compact_ms_ is spent
+	void Checker::compact_frames ()
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+		std::chrono::steady_clock::time_point deadline = start + std::chrono::milliseconds (compact_ms_);
+		frame_gens_.resize (F_.size (), 0);
+		compacted_gens_.resize (F_.size (), -1);
+		int checked = 0, removed = 0;
+		for (int i = F_.size () - 1; i >= 0 && std::chrono::steady_clock::now () < deadline; i --){
+			if (compacted_gens_[i] == frame_gens_[i])
+				continue;
+			if (compact_frame (i, deadline, checked, removed))
+				compacted_gens_[i] = frame_gens_[i];
+		}
+		std::chrono::duration<double> time = std::chrono::steady_clock::now () - start;
+		stats_->count_compaction (checked, removed, time.count ());
+	}
+	
+	//drop the cubes of F_[n] whose clause is implied by the clauses of the other cubes, so the
+	//states of the frame do not change. Return false if the deadline came first
+	bool Checker::compact_frame (const int n, const std::chrono::steady_clock::time_point deadline, int& checked, int& removed)
+	{
+		Frame& frame = F_[n];
+		if (frame.size () < 2)
+			return true;
+		//cube j is enabled by the flag first+j
+		CARSolver sat (backends_[ROLE_MAIN]);
+		int first = model_->max_id () + 1;
+		for (int j = 0; j < frame.size (); j ++){
+			Clause cl;
+			cl.push_back (-(first + j));
+			for (int k = 0; k < frame[j].size (); k ++)
+				cl.push_back (-frame[j][k]);
+			sat.add_clause (cl);
+		}
+		//the longest cubes are the most likely to be implied
+		std::vector<int> order (frame.size ());
+		for (int j = 0; j < order.size (); j ++)
+			order[j] = j;
+		std::stable_sort (order.begin (), order.end (), [&frame] (int a, int b) {return frame[a].size () > frame[b].size ();});
+		
+		std::vector<bool> kept (frame.size (), true);
+		bool done = true;
+		int num = 0;
+		for (int k = 0; k < order.size (); k ++){
+			if (std::chrono::steady_clock::now () >= deadline){
+				done = false;
+				break;
+			}
+			int j = order[k];
+			sat.assumption_.clear ();
+			for (int l = 0; l < frame.size (); l ++)
+				if (l != j && kept[l])
+					sat.assumption_push (first + l);
+			for (int l = 0; l < frame[j].size (); l ++)
+				sat.assumption_push (frame[j][l]);
+			checked ++;
+			try {
+				if (sat.solve_assumption ())
+					continue;
+			}
+			catch (ResourceOut& e) {
+				//the cube is kept if the query exceeds the SAT budgets, the run only stops if interrupted
+				if (Resources::interrupted () || Resources::cancelled ())
+					throw;
+				continue;
+			}
+			kept[j] = false;
+			num ++;
+		}
+		if (num > 0){
+			Frame res;
+			for (int j = 0; j < frame.size (); j ++)
+				if (kept[j])
+					res.push_back (frame[j]);
+			frame = res;
+			solver_->reset_frame (frame, n, forward_);
+			removed += num;
+		}
+		return done;
+	}
+	
 	bool Checker::propagate (Cube& cu, int n){
 		solver_->set_assumption (cu, n, forward_);
 		//solver_->print_assumption();
@@ -376,6 +1036,7 @@ namespace car
 	//////////////helper functions/////////////////////////////////////////////
 
 	Checker::Checker (Model* model, Statistics& stats, ofstream* dot, bool forward, bool evidence, bool partial, bool propagate, bool begin, bool end, bool inter, bool rotate, bool verbose, bool minimal_uc,bool dead)
+	    : state_context_ (model->num_inputs (), model->num_latches ()), log_ (cout, verbose ? LOG_DEBUG : LOG_INFO)
 	{
 	    
 		model_ = model;
@@ -386,7 +1047,7 @@ namespace car
 		dead_solver_ = NULL;
 		start_solver_ = NULL;
 		inv_solver_ = NULL;
-		init_ = new State (model_->init ());
+		init_ = new State (&state_context_, model_->init ());
 		last_ = NULL;
 		forward_ = forward;
 		safe_reported_ = false;
@@ -400,8 +1061,27 @@ namespace car
 		dead_ = dead; //enable dead
 
 		dead_flag_ = false;
+		for (int i = 0; i < ROLE_NUM; i ++)
+			backends_[i] = BACKEND_MINISAT;
+		parallel_conflicts_ = 0;
+		parallel_threads_ = 0;
+		phase_ = PHASE_NONE;
+		checkpoint_ = NULL;
+		design_hash_ = 0;
+		property_ = 0;
+		constraint_gen_ = 0;
 		//set propagate_ to be true by default
 		propagate_ = propagate;
+		compact_ms_ = 0;
+		evict_age_ = 0;
+		iteration_ = 0;
+		tuner_ = NULL;
+		tuned_orig_uc_ = tuned_reduce_uc_ = 0;
+		tuned_uc_time_ = 0.0;
+		spec_workers_ = 0;
+		bad_batch_ = 0;
+		lemmas_ = NULL;
+		lemma_member_ = 0;
 		
 		begin_ = begin;
 		end_ = end;
@@ -420,9 +1100,29 @@ namespace car
 		    delete last_;
 		    last_ = NULL;
 		}
+		if (tuner_ != NULL)
+		{
+			delete tuner_;
+			tuner_ = NULL;
+		}
 		car_finalization ();
 	}
 	
+	void Checker::set_auto (const bool on)
+	{
+		if (!on || tuner_ != NULL)
+			return;
+		//dead states and partial states are for forward CAR only
+		bool usable[TECH_NUM];
+		usable[TECH_DEAD] = usable[TECH_PARTIAL] = forward_;
+		usable[TECH_MUC] = usable[TECH_PROPAGATE] = true;
+		tuner_ = new AutoTuner (usable);
+		dead_ = tuner_->on (TECH_DEAD);
+		minimal_uc_ = tuner_->on (TECH_MUC);
+		partial_state_ = tuner_->on (TECH_PARTIAL);
+		propagate_ = tuner_->on (TECH_PROPAGATE);
+	}
+	
 	void Checker::destroy_states ()
 	{    
 	    for (int i = 0; i < B_.size (); i ++)
@@ -443,13 +1143,23 @@ namespace car
 	
 	void Checker::car_initialization ()
 	{
-	    solver_ = new MainSolver (model_, stats_, verbose_);
+	    solver_ = new MainSolver (model_, stats_, trace_log (), backends_[ROLE_MAIN]);
 	    if (forward_){
-	    	lift_ = new MainSolver (model_, stats_, verbose_);
-	    	dead_solver_ = new MainSolver (model_, stats_, verbose_);
+	    	//lift_ and dead_solver_ start from the same transition relation as solver_,
+	    	//which can only be cloned when they use the same backend
+	    	if (backends_[ROLE_LIFT] == backends_[ROLE_MAIN])
+	    		lift_ = solver_->clone ();
+	    	else
+	    		lift_ = new MainSolver (model_, stats_, trace_log (), backends_[ROLE_LIFT]);
+	    	if (backends_[ROLE_DEAD] == backends_[ROLE_MAIN])
+	    		dead_solver_ = solver_->clone ();
+	    	else
+	    		dead_solver_ = new MainSolver (model_, stats_, trace_log (), backends_[ROLE_DEAD]);
 	    	dead_solver_->add_clause (-bad_);
 	    }
-		start_solver_ = new StartSolver (model_, bad_, forward_, verbose_);
+	    if (parallel_conflicts_ > 0)
+	    	solver_->enable_parallel (parallel_conflicts_, parallel_threads_);
+		start_solver_ = new StartSolver (model_, bad_, forward_, trace_log (), backends_[ROLE_START]);
 		assert (F_.empty ());
 		assert (B_.empty ());
 		
@@ -466,7 +1176,20 @@ namespace car
 		*/
 		
 	    F_.clear ();
+	    frame_gens_.clear ();
+	    propagated_gens_.clear ();
+	    propagated_constraints_.clear ();
+	    compacted_gens_.clear ();
+	    last_used_.clear ();
+	    archive_.clear ();
 	    destroy_states ();
+	    for (int i = 0; i < start_queue_.size (); i ++)
+	    	delete start_queue_[i];
+	    start_queue_.clear ();
+	    if (checkpoint_ != NULL) {
+	        delete checkpoint_;
+	        checkpoint_ = NULL;
+	    }
 	    if (solver_ != NULL) {
 	        delete solver_;
 	        solver_ = NULL;
@@ -496,7 +1219,7 @@ namespace car
 	        if (forward_)
 	            init_->set_inputs (pa.first);
 	        else
-	            last_ = new State (NULL, pa.first, pa.second, forward_, true);
+	            last_ = new State (&state_context_, NULL, pa.first, pa.second, forward_, true);
 	        
 	        return true;
 	    }
@@ -537,6 +1260,19 @@ namespace car
 		
 	State* Checker::enumerate_start_state ()
 	{
+		while (forward_ && bad_batch_ > 1)
+		{
+			if (start_queue_.empty ())
+				fill_start_queue ();
+			if (start_queue_.empty ())
+				return NULL;
+			State* s = start_queue_.front ();
+			start_queue_.pop_front ();
+			if (!start_blocked (s))
+				return s;
+			stats_->count_start_batch_stale ();
+			delete s;
+		}
 		while (true)
 		{
 			//start_solver_->print_assumption ();
@@ -555,17 +1291,58 @@ namespace car
 		return NULL;
 	}
 	
-	State* Checker::get_new_start_state ()
+	//the states of a batch are apart: the lifted latches of each one are blocked in the start
+	//solver until the batch ends, otherwise the first UC found mostly blocks the others
+	void Checker::fill_start_queue ()
+	{
+		start_solver_->begin_batch ();
+		Cube region;
+		for (int i = 0; i < bad_batch_; i ++){
+			if (!start_solver_solve_with_assumption ())
+				break;
+			State* s = get_new_start_state (&region);
+			start_solver_->block_in_batch (region);
+			start_queue_.push_back (s);
+		}
+		start_solver_->end_batch ();
+		stats_->count_start_batch (int (start_queue_.size ()));
+	}
+	
+	//the UCs found since the batch was taken may block s at frame_
+	bool Checker::start_blocked (const State* s)
+	{
+		for (int i = 0; i < frame_.size (); i ++){
+			if (full_state (s) ? s->imply (frame_[i]) : car::imply (s->s (), frame_[i]))
+				return true;
+		}
+		return false;
+	}
+	
+	State* Checker::get_new_start_state (Cube* region)
 	{
 		Assignment st = start_solver_->get_model ();
-		Cube st_input = model_->shrink_to_input_vars(st);
+		//the inputs and latches come first
 		assert (st.size() >= model_->num_inputs() + model_->num_latches());
 		st.resize (model_->num_inputs() + model_->num_latches());
-		if (partial_state_)
+		Cube st_input = model_->shrink_to_input_vars(st);
+		if (region != NULL && !partial_state_){
+			Assignment lifted = st;
+			get_partial (lifted);
+			region->clear ();
+			for (int i = 0; i < lifted.size (); i ++)
+				if (model_->latch_var (abs (lifted[i])))
+					region->push_back (lifted[i]);
+		}
+		if (partial_state_){
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
 			get_partial (st);
+			count_tuned (TECH_PARTIAL, start, model_->num_latches (), model_->num_latches () - int (st.size ()));
+		}
 		std::pair<Assignment, Assignment> pa = state_pair (st);
+		if (region != NULL && partial_state_)
+			*region = pa.second;
 		//State *res = new State (NULL, pa.first, pa.second, forward_, true);
-		State *res = new State (NULL, st_input, pa.second, forward_, true);
+		State *res = new State (&state_context_, NULL, st_input, pa.second, forward_, true);
 		return res;
 	}
 	
@@ -652,6 +1429,8 @@ namespace car
 				//delete frames after i, and the left F_ is the invariant
 				while (F_.size () > i+1)
 					F_.pop_back ();
+				if (archive_.size () > F_.size ())
+					archive_.resize (F_.size ());
 				//cout << "invariant found at frame " << i << endl;
 				break;
 			}
@@ -684,13 +1463,15 @@ namespace car
 	void Checker::inv_solver_add_constraint_or (const int frame_level)
 	{
 		//add \bigcup F_i (\bigcup B_i)
-		inv_solver_->add_constraint_or (F_[frame_level], forward_);
+		Frame tmp;
+		inv_solver_->add_constraint_or (frame_with_archive (frame_level, tmp), forward_);
 	}
 	
 	void Checker::inv_solver_add_constraint_and (const int frame_level)
 	{
 		//add \neg F_{frame_level} (\neg B_{frame_level})
-		inv_solver_->add_constraint_and (F_[frame_level], forward_);
+		Frame tmp;
+		inv_solver_->add_constraint_and (frame_with_archive (frame_level, tmp), forward_);
 	}
 	
 	void Checker::inv_solver_release_constraint_and ()
@@ -703,11 +1484,44 @@ namespace car
 		if (frame_level == -1)
 			return immediate_satisfiable (s);
 				
+		if (phase_ != PHASE_NONE)
+			seed_phase (s, frame_level);
 		bool res = solver_solve_with_assumption (s, frame_level, forward_);
+		if (res && phase_ == PHASE_LAST)
+		{
+			if (frame_level >= phase_models_.size ())
+				phase_models_.resize (frame_level+1);
+			phase_models_[frame_level] = solver_->get_state (forward_, false);
+		}
 		
 		return res;
 	}
 	
+	//make solver_ first try the latch values of s (states tend to change few latches in one step),
+	//or the inputs and latches of the last state it found at frame_level for PHASE_LAST.
+	//The values are set on the latches of the state to be found, i.e. the current latches in
+	//forward CAR and the primed latches in backward CAR.
+	void Checker::seed_phase (const Cube& s, const int frame_level)
+	{
+		const Assignment* st = &s;
+		if (phase_ == PHASE_LAST && frame_level < phase_models_.size () && !phase_models_[frame_level].empty ())
+			st = &phase_models_[frame_level];
+		
+		Assignment lits;
+		lits.reserve (st->size ());
+		for (Assignment::const_iterator it = st->begin (); it != st->end (); it ++)
+		{
+			int id = *it;
+			if (id == 0)  //DON'T CARE input
+				continue;
+			if (forward_ || abs (id) <= model_->num_inputs ())
+				lits.push_back (id);
+			else
+				lits.push_back (model_->prime (id));
+		}
+		solver_->set_phase (lits);
+	}
+	
 	bool Checker::solve_for_recursive (Cube& s, int frame_level, Cube& tmp_block){
 		assert (frame_level != -1);
 		
@@ -720,11 +1534,14 @@ namespace car
 		Assignment st = solver_->get_state (forward_, partial_state_);
 		Cube st_input = model_->shrink_to_input_vars(st);
 		//st includes both input and latch parts
-		if (partial_state_)
+		if (partial_state_){
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
 			get_partial (st, s);
+			count_tuned (TECH_PARTIAL, start, model_->num_latches (), model_->num_latches () - int (st.size ()));
+		}
 		std::pair<Assignment, Assignment> pa = state_pair (st);
 		//State* res = new State (s, pa.first, pa.second, forward_);
-		State* res = new State (s, st_input, pa.second, forward_);
+		State* res = new State (&state_context_, s, st_input, pa.second, forward_);
 		
 		
 		return res;
@@ -786,6 +1603,8 @@ namespace car
 	
 	void Checker::extend_F_sequence ()
 	{
+		if (checkpoint_ != NULL)
+			checkpoint_->new_frame (F_.size (), cube_, comm_);
 		F_.push_back (frame_);
 		cubes_.push_back (cube_);
 		comms_.push_back (comm_);
@@ -800,6 +1619,8 @@ namespace car
 	        B_.push_back (v);
 	    }
 	    B_[s->depth ()].push_back (s);
+	    if (checkpoint_ != NULL)
+	    	checkpoint_->add_state (s);
 	}
 	
 	void Checker::update_F_sequence (const State* s, const int frame_level)
@@ -819,28 +1640,7 @@ namespace car
 		*/
 		
 		
-		//foward cu MUST rule out those not in \@s
-		if (forward_){
-			Cube tmp;
-			Cube &st = s->s();
-			if (!partial_state_){
-				for(auto it = cu.begin(); it != cu.end(); ++it){
-					int latch_start = model_->num_inputs()+1;
-					if (st[abs(*it)-latch_start] == *it)
-						tmp.push_back (*it);
-				}
-			}
-			else{
-				hash_set<int> tmp_set;
-				for (auto it = st.begin (); it != st.end(); ++it)
-					tmp_set.insert (*it);
-				for (auto it = cu.begin(); it != cu.end(); ++it){
-					if (tmp_set.find (*it) != tmp_set.end())
-						tmp.push_back (*it);
-				}
-			}
-			cu = tmp;
-		}
+		state_uc (cu, s->s ());
 		
 		//assert (!cu.empty());
 		
@@ -861,12 +1661,39 @@ namespace car
 			return;
 		}
 		
+		add_uc (cu, frame_level);
+	}
+	
+	//the UC cu of a query of the state st, made a cube of the states blocked for good
+	void Checker::state_uc (Cube& cu, const Cube& st)
+	{
+		//foward cu MUST rule out those not in \@s
+		if (forward_){
+			Cube tmp;
+			if (st.size () == model_->num_latches ()){
+				for(auto it = cu.begin(); it != cu.end(); ++it){
+					int latch_start = model_->num_inputs()+1;
+					if (st[abs(*it)-latch_start] == *it)
+						tmp.push_back (*it);
+				}
+			}
+			else{
+				hash_set<int> tmp_set;
+				for (auto it = st.begin (); it != st.end(); ++it)
+					tmp_set.insert (*it);
+				for (auto it = cu.begin(); it != cu.end(); ++it){
+					if (tmp_set.find (*it) != tmp_set.end())
+						tmp.push_back (*it);
+				}
+			}
+			cu = tmp;
+		}
 		
 		if (forward_){
 			if (is_initial (cu)){
-				auto it = s->s().begin();
+				auto it = st.begin();
 				while ((*it) < 0) ++it;
-				assert (it != s->s().end());
+				assert (it != st.end());
 				int i = 0;
 				for (; i < cu.size(); ++i)
 					if (abs(cu[i]) > abs(*it))
@@ -874,17 +1701,16 @@ namespace car
 				cu.insert (cu.begin()+i, *it);
 			}
 		}
-		
-		
+	}
+	
+	void Checker::add_uc (Cube& cu, const int frame_level)
+	{
 		push_to_frame (cu, frame_level);
 		
-		
 		if (forward_){
 			for (int i = frame_level-1; i >= 1; --i)
 				push_to_frame (cu, i);
 		}
-		
-		
 	}
 	
 	bool Checker::is_dead (const State* s, Cube& dead_uc){
@@ -892,8 +1718,8 @@ namespace car
 		Cube assumption;
 		
 		Cube common;
-		if (deads_.size() > 0) 
-			common = car::cube_intersect (deads_[deads_.size()-1], s->s());
+		if (!deads_.empty ()) 
+			common = car::cube_intersect (deads_.last (), s->s());
 			
 		for (auto it = common.begin(); it != common.end(); ++it)
 			assumption.push_back (forward_ ? model_->prime (*it) : (*it));
@@ -926,7 +1752,7 @@ namespace car
 			if (forward_){
 				Cube tmp;
 				Cube &st = s->s();
-				if (!partial_state_){
+				if (full_state (s)){
 					for(auto it = dead_uc.begin(); it != dead_uc.end(); ++it){
 						int latch_start = model_->num_inputs()+1;
 						if (st[abs(*it)-latch_start] == *it)
@@ -980,13 +1806,16 @@ namespace car
 			if (!s->added_to_dead_solver ()){
 				dead_solver_->CARSolver::add_clause_from_cube (s->s());
 				s->set_added_to_dead_solver (true);
+				if (checkpoint_ != NULL)
+					checkpoint_->add_alive (s);
 			}
 		}
 		return !res;
 	}
 	
 	void Checker::add_dead_to_inv_solver (){
-		for (auto it = deads_.begin (); it != deads_.end(); ++it){
+		std::vector<Cube> deads = deads_.cubes ();
+		for (auto it = deads.begin (); it != deads.end(); ++it){
 			Clause cl;	
 			for (auto it2 = (*it).begin(); it2 != (*it).end (); ++it2){
 				cl.push_back (forward_? -(*it2) : -model_->prime(*it2));
@@ -1025,13 +1854,11 @@ namespace car
 	}
 	
 	void Checker::add_dead_to_solvers (Cube& dead_uc){
-		std::vector<Cube> tmp_deads;
-		for (auto it = deads_.begin (); it != deads_.end (); ++it){
-			if (!imply (*it, dead_uc))
-				tmp_deads.push_back (*it);
-		}
-		deads_ = tmp_deads;
-		deads_.push_back (dead_uc);
+		if (checkpoint_ != NULL)
+			checkpoint_->add_dead (dead_uc);
+		if (lemmas_ != NULL)
+			export_lemma (dead_uc);
+		deads_.add (dead_uc);
 		//car::print (dead_uc);
 		
 		Clause cl;	
@@ -1039,6 +1866,7 @@ namespace car
 			cl.push_back (forward_? -(*it) : -model_->prime(*it));
 		}
 		start_solver_->add_clause (cl);
+		constraint_gen_ ++;
 		
 		if (is_initial (dead_uc)){
 			//create dead clauses : MUST consider the initial state not excluded by dead states!!!
@@ -1079,7 +1907,7 @@ namespace car
 	Cube Checker::recursive_block (State* s, int frame_level, Cube cu, Cube& next_cu){
 		
 		Cube common = s->s();
-		State *tmp_s = new State (common);
+		State *tmp_s = new State (&state_context_, common);
 		
 		while (true){
 			
@@ -1176,9 +2004,15 @@ namespace car
 		}
 		*/
 		frame = tmp_frame;
+		if (checkpoint_ != NULL)
+			checkpoint_->add_cube (frame_level, cu);
 		
 		if (frame_level-1 < minimal_update_level_)
 			minimal_update_level_ = frame_level;
+		if (frame_level >= frame_gens_.size ())
+			frame_gens_.resize (frame_level+1, 0);
+		frame_gens_[frame_level] ++;
+		touch_cube (frame_level, cu);
 		
 		if (frame_level < int (F_.size ()))
 			solver_->add_clause_from_cube (cu, frame_level, forward_);
@@ -1191,9 +2025,11 @@ namespace car
 	    for (int i = 0; i < frame_level; i ++){
 	        int j = 0;
 	        for (; j < F_[i].size (); j ++){
-	        	bool res = partial_state_ ? car::imply (s->s(), F_[i][j]) : s->imply (F_[i][j]);
-	            if (res)
+	        	bool res = full_state (s) ? s->imply (F_[i][j]) : car::imply (s->s(), F_[i][j]);
+	            if (res){
+	            	touch_cube (i, F_[i][j]);
 	                break;
+	            }
 	        }
 	        if (j >= F_[i].size ())
 	            return i-1;
@@ -1205,26 +2041,22 @@ namespace car
 		//check whether st is a dead state	
 		if (st->is_dead ()) 
 			return true;
-		for(auto it = deads_.begin(); it != deads_.end(); ++it){
-			bool res = partial_state_ ? car::imply (st->s(), *it) : st->imply (*it);
-			res = res && !is_initial (st->s());
-			if (res){
-				st->mark_dead ();
-				return true;
-			}
+		if (deads_.covering (st->s ()) != NULL && !is_initial (st->s ())){
+			st->mark_dead ();
+			if (checkpoint_ != NULL)
+				checkpoint_->mark_dead (st);
+			return true;
 		}
 		//end of check
 		
 	    assert (frame_level >= 0);
 	    Frame &frame = (frame_level < F_.size ()) ? F_[frame_level] : frame_;
-	    if (!partial_state_){
-	    	//assume that st is a full state
-	    	assert (const_cast<State*>(st)->size () == model_->num_latches ());
-	    
+	    if (full_state (st)){
 	    	stats_->count_state_contain_time_start ();
 	    	for (int i = 0; i < frame.size (); i ++) {
 	        	if (st->imply (frame[i])) {
 	            	stats_->count_state_contain_time_end ();
+	            	touch_cube (frame_level, frame[i]);
 	            	return true;
 	        	} 
 	    	}
@@ -1235,6 +2067,7 @@ namespace car
 	    	for (int i = 0; i < frame.size (); i ++) {
 	        	if (car::imply (st->s(), frame[i])) {
 	            	stats_->count_state_contain_time_end ();
+	            	touch_cube (frame_level, frame[i]);
 	            	return true;
 	        	} 
 	    	}
@@ -1374,7 +2207,7 @@ namespace car
 	}
 	
 		
-	void Checker::print_evidence (ofstream& out) {
+	void Checker::print_evidence (ostream& out) {
 		if (forward_)
 			init_->print_evidence (forward_, out);
 		else
@@ -32,14 +32,26 @@
 #include <assert.h>
 #include "utility.h"
 #include "statistics.h"
+#include "checkpoint.h"
+#include "framecache.h"
+#include "logger.h"
+#include "deadstore.h"
+#include "autotune.h"
+#include "specpool.h"
+#include "lemmachannel.h"
 #include <fstream>
+#include <deque>
 #include <algorithm>
+#include <chrono>
 
 #define MAX_SOLVER_CALL 500
 #define MAX_TRY 4
 
 namespace car 
 {
+	//where the saved phases of the main solver are seeded from before each successor query
+	enum PhaseMode {PHASE_NONE, PHASE_STATE, PHASE_LAST};
+	
     class Comparator {
     public:
         //Comparator (std::vector<int>& counter): counter_ (counter) {}
@@ -62,14 +74,49 @@ namespace car
 		Checker (Model* model, Statistics& stats, std::ofstream* dot, bool forward = true, bool evidence = false, bool partial = false, bool propagate = false, bool begin = false, bool end = true, bool inter = true, bool rotate = false, bool verbose = false, bool minimal_uc = false,bool dead = false);
 		~Checker ();
 		
-		bool check (std::ofstream&);
-		void print_evidence (std::ofstream&);
+		bool check (std::ostream&);
+		void print_evidence (std::ostream&);
+		//choose the SAT backend for a solver role, must be called before check
+		inline void set_sat_backend (const SolverRole role, const SATBackend backend) {backends_[role] = backend;}
+		//escalate solver_ queries exceeding conflicts to parallel Glucose, must be called before check
+		inline void set_parallel (const long long conflicts, const int threads) {
+			parallel_conflicts_ = conflicts;
+			parallel_threads_ = threads;
+		}
+		inline void set_phase (const PhaseMode mode) {phase_ = mode;}
+		//after each new frame, drop the cubes implied by the rest of their frame, spending at
+		//most ms milliseconds (-compact)
+		inline void set_compact (const int ms) {compact_ms_ = ms;}
+		//after each new frame, move the cubes which have not blocked a state in the last age frame
+		//levels out of the frames and solver_ (-evict)
+		inline void set_evict (const int age) {evict_age_ = age;}
+		//switch the dead states, minimal UCs, partial states and propagation on and off at each
+		//frame level by their costs and gains (-auto), must be called before check
+		void set_auto (const bool on);
+		//at each frame level, first search from the states of B_ with workers threads (-spec)
+		inline void set_spec (const int workers) {spec_workers_ = workers;}
+		//forward: take up to n start states per start solver batch, blocking the ones found in
+		//the batch (-bad-batch), 0 for one state per SAT call
+		inline void set_bad_batch (const int n) {bad_batch_ = n;}
+		//send the cubes of the new frames and the dead cubes to lemmas as member, and try those of
+		//the other members at each frame level (-portfolio), NULL for none
+		inline void set_lemmas (LemmaChannel* lemmas, const int member) {lemmas_ = lemmas; lemma_member_ = member;}
+		//log the frames to file at each frame level (-checkpoint), or start from such a log (-resume)
+		inline void set_checkpoint (const std::string& file) {checkpoint_file_ = file;}
+		inline void set_resume (const std::string& file) {resume_file_ = file;}
+		//warm start from the frames of previous runs kept in dir (-cache), design is FrameCache::hash
+		inline void set_cache (const std::string& dir, const unsigned long long design) {cache_dir_ = dir; design_hash_ = design;}
+		//progress and verbose messages go to out instead of std::cout, must be called before check
+		inline void set_log (std::ostream& out) {log_.set_output (out);}
+		inline void set_log_level (const LogLevel level) {log_.set_level (level);}
+		//check output p instead of the first one, must be called before check
+		inline void set_property (const int p) {property_ = p;}
 		inline int frame_size () {return frame_.size ();}
 		inline void print_frames_sizes () {
+		    LogLine line (log_, LOG_INFO);
 		    for (int i = 0; i < F_.size (); i ++) {
-		        std::cout << F_[i].size () << " ";
+		        line << F_[i].size () << " ";
 		    }
-		    std::cout << std::endl;
 		}
 	protected:
 		//flags 
@@ -84,18 +131,55 @@ namespace car
 		//new flags for reorder and state enumeration
 		bool begin_, end_;  // for state enumeration
 		bool inter_, rotate_; //for reorder
+		SATBackend backends_[ROLE_NUM];  //SAT backend of each solver role
+		long long parallel_conflicts_;  //0 means no escalation to parallel Glucose
+		int parallel_threads_;
+		PhaseMode phase_;
+		std::vector<Assignment> phase_models_;  //last state found by solver_ at each frame level, for PHASE_LAST
+		std::string checkpoint_file_, resume_file_;
+		CheckpointLog* checkpoint_;  //NULL if no checkpoint is written
+		std::string cache_dir_;
+		unsigned long long design_hash_;
+		std::vector<Frame> seeds_;  //cubes of the cache to seed, by frame level
 		//
 		//members
 		Statistics *stats_;
 		
 		std::ofstream* dot_; //for dot file
+		Logger log_;  //for messages
+		std::vector<int> reported_sizes_;  //of the frames at the last report of LOG_FRAMES
+		std::chrono::steady_clock::time_point reported_;  //last report of LOG_INFO
 		int solver_call_counter_; //counter for solver_ calls
 		int start_solver_call_counter_; //counter for start_solver_ calls
 		
 		int minimal_update_level_;
+		std::vector<int> frame_gens_;  //number of cubes added to each frame, by push_to_frame
+		std::vector<int> propagated_gens_;  //of each frame at the end of its last propagation, -1 if none
+		int constraint_gen_;  //clauses added to solver_ outside the frames, the dead cubes
+		std::vector<int> propagated_constraints_;  //constraint_gen_ at the last propagation of each frame
+		int compact_ms_;  //0 means no compaction
+		std::vector<int> compacted_gens_;  //of each frame at its last complete compaction, -1 if none
+		int evict_age_;  //0 means no eviction
+		int iteration_;  //frame levels started by car_check, the clock of the cube activity
+		std::vector<hash_map<Cube, int, CubeHash> > last_used_;  //by level, the iteration a cube was added or last blocked a state
+		//the cubes evicted from each frame. The search only sees the frames, which are larger sets
+		//of states and so still over-approximations, but the invariant check needs the archive:
+		//the cubes of F_[i+1] exclude the successors of F_[i] with its evicted cubes
+		Fsequence archive_;
+		AutoTuner* tuner_;  //NULL without -auto
+		long long tuned_orig_uc_, tuned_reduce_uc_;  //of stats_ at the last tune
+		double tuned_uc_time_;
+		int spec_workers_;  //0 means no speculation
+		int bad_batch_;
+		std::deque<State*> start_queue_;  //the start states of the batch not tried yet
+		LemmaChannel* lemmas_;
+		int lemma_member_;
+		hash_set<Cube, CubeHash> exported_;
 		State* init_;  // the start state for forward CAR
 		State* last_;  // the start state for backward CAR
 		int bad_;
+		int property_;  //index of the output checked
+		StateContext state_context_;  //of the states of this checker
 
 		Model* model_;
 		MainSolver *solver_;
@@ -116,7 +200,7 @@ namespace car
 	    std::vector<State*> states_;
 	    std::vector<Cube> comms_;
 	    Cube comm_; 
-	    std::vector<Cube> deads_;
+	    DeadStore deads_;
 	    bool dead_flag_;
 		
 		bool safe_reported_;  //true means ready to return SAFE
@@ -134,9 +218,12 @@ namespace car
 		void inv_solver_add_constraint_and (const int frame_level);
 		void inv_solver_release_constraint_and ();
 		bool solve_with (const Cube &cu, const int frame_level);
+		void seed_phase (const Cube& s, const int frame_level);
 		State* get_new_state (const State *s);
 		void extend_F_sequence ();
 		void update_F_sequence (const State* s, const int frame_level);
+		void state_uc (Cube& cu, const Cube& st);
+		void add_uc (Cube& cu, const int frame_level);
 		void update_frame_by_relative (const State* s, const int frame_level);
 		void update_B_sequence (State* s);
 		int get_new_level (const State *s, const int frame_level);
@@ -145,13 +232,54 @@ namespace car
 		
 		
 		State* enumerate_start_state ();
-		State* get_new_start_state ();
+		//region: the latches to block for the batch (-bad-batch), NULL out of a batch
+		State* get_new_start_state (Cube* region = NULL);
+		void fill_start_queue ();
+		bool start_blocked (const State* s);
 		std::pair<Assignment, Assignment> state_pair (const Assignment& st);
 		
 		void car_initialization ();
 		void car_finalization ();
 		void destroy_states ();
 		bool car_check ();
+		void report_unknown (std::ostream& out, const int i, const char* reason);
+		void report_frames (const int frame_level);
+		void compact_frames ();
+		void evict_frames ();
+		void tune (const int frame_level);
+		bool speculate (const int frame_level);
+		void spec_work (SpecPool& pool, const int worker, MainSolver* solver, const int top);
+		void spec_step (SpecPool& pool, const int worker, MainSolver* solver, SpecTask t, const int top,
+		                const Fsequence& found);
+		State* spec_state (SpecNode* n);
+		bool spec_blocked (const Cube& st, const int frame_level, const Fsequence& found);
+		int spec_level (const Cube& st, const int frame_level, const Fsequence& found);
+		void spec_priority (Assignment& st, const int frame_level, const Fsequence& found);
+		//st is a full state, as State::imply
+		inline bool spec_imply (const Cube& st, const Cube& cu) {
+			int latch_start = model_->num_inputs () + 1;
+			for (int i = 0; i < cu.size (); ++ i)
+				if (st[abs (cu[i]) - latch_start] != cu[i])
+					return false;
+			return true;
+		}
+		//give the work of t since start to the tuner of -auto, if any
+		inline void count_tuned (const Technique t, const std::chrono::steady_clock::time_point& start, const long long tries, const long long hits) {
+			if (tuner_ != NULL)
+				tuner_->count (t, tries, hits, std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ());
+		}
+		//a state of all the latches, in their order, and not a partial one
+		inline bool full_state (const State* s) const {return const_cast<State*> (s)->size () == model_->num_latches ();}
+		const Frame& frame_with_archive (const int level, Frame& tmp);
+		bool compact_frame (const int n, const std::chrono::steady_clock::time_point deadline, int& checked, int& removed);
+		int start_checkpoint ();
+		void replay (const std::vector<CheckpointEvent>& events);
+		bool load_cache ();
+		bool cached_invariant (const std::vector<Frame>& frames, std::vector<Cube>& deads);
+		void seed_frame ();
+		void export_lemma (const Cube& cu);
+		void import_lemmas ();
+		void save_cache (const bool safe);
 		
 		void get_partial (Assignment& st, const State* s=NULL);
 		void add_dead_to_solvers (Cube& dead_uc);
@@ -171,8 +299,16 @@ namespace car
 		
 		//inline functions
 		inline bool is_initial (Cube& c){return init_->imply (c);}
+		//cu of the frame at level is still in use
+		inline void touch_cube (const int level, const Cube& cu){
+			if (evict_age_ == 0)
+				return;
+			if (level >= last_used_.size ())
+				last_used_.resize (level+1);
+			last_used_[level][cu] = iteration_;
+		}
 		inline void create_inv_solver (){
-			inv_solver_ = new InvSolver (model_, verbose_);
+			inv_solver_ = new InvSolver (model_, trace_log (), backends_[ROLE_INV]);
 			add_dead_to_inv_solver ();
 		}
 		inline void delete_inv_solver (){
@@ -207,7 +343,7 @@ namespace car
 	    
 	    inline void reconstruct_start_solver () {
 	        delete start_solver_;
-	        start_solver_ = new StartSolver (model_, bad_, forward_, verbose_);
+	        start_solver_ = new StartSolver (model_, bad_, forward_, trace_log (), backends_[ROLE_START]);
 	        for (int i = 0; i < frame_.size (); i ++) {
 	            start_solver_->add_clause_with_flag (frame_[i]);
 	        }
@@ -235,20 +371,29 @@ namespace car
 	    
 	    inline void reconstruct_solver () {
 	        delete solver_;
-	        solver_ = new MainSolver (model_, stats_, verbose_);
+	        solver_ = new MainSolver (model_, stats_, trace_log (), backends_[ROLE_MAIN]);
+	        if (parallel_conflicts_ > 0)
+	        	solver_->enable_parallel (parallel_conflicts_, parallel_threads_);
 	        for (int i = 0; i < F_.size (); i ++) {
 	            solver_->add_new_frame (F_[i], i, forward_);
 	        }
 	    }
 	    
+	    inline void count_main_solver_search (const SATStats& before){
+	        SATStats after = solver_->sat_stats ();
+	        stats_->count_main_solver_search (after.decisions-before.decisions, after.conflicts-before.conflicts);
+	    }
+	    
 	    inline bool solver_solve_with_assumption (const Assignment& st, const int p){
 	        //if (reconstruct_solver_required ())
 	            //reconstruct_solver ();
 	        Assignment st2 = st;
 	        add_intersection_last_uc_in_frame_level_plus_one (st2, -1);
+	        SATStats before = solver_->sat_stats ();
 	        stats_->count_main_solver_SAT_time_start ();
 	        bool res = solver_->solve_with_assumption (st2, p);
 	        stats_->count_main_solver_SAT_time_end ();
+	        count_main_solver_search (before);
 	        if (!res) {
 	        	Assignment st3; 
 		    	st3.reserve (model_->num_latches());
@@ -269,9 +414,11 @@ namespace car
 	        Assignment st2 = st;
 	        add_intersection_last_uc_in_frame_level_plus_one (st2, frame_level);
 	        solver_->set_assumption (st2, frame_level, forward);
+	        SATStats before = solver_->sat_stats ();
 	        stats_->count_main_solver_SAT_time_start ();
 		    bool res = solver_->solve_with_assumption ();
 		    stats_->count_main_solver_SAT_time_end ();
+		    count_main_solver_search (before);
 		    if (!res) {
 		    	Assignment st3; 
 		    	st3.reserve (model_->num_latches());
@@ -286,6 +433,8 @@ namespace car
 	    }
 	    
 	    inline void clear_frame (){
+	        if (checkpoint_ != NULL)
+	        	checkpoint_->clear_frame ();
 	        frame_.clear ();
 	        cube_.clear ();
 		comm_.clear ();
@@ -295,28 +444,34 @@ namespace car
 	    
 	    
 	    inline void print_frame (const Frame& f){
-	        for (int i = 0; i < f.size (); i ++)
-	            car::print (f[i]);
+	        for (int i = 0; i < f.size (); i ++){
+	            LogLine line (log_, LOG_DEBUG);
+	            for (int j = 0; j < f[i].size (); j ++)
+	                line << f[i][j] << " ";
+	        }
 	    }
 	    
 	    inline void print_F (){
-	        std::cout << "-----------F sequence information------------" << std::endl;
+	        LogLine (log_, LOG_DEBUG) << "-----------F sequence information------------";
 	        for (int i = 0; i < F_.size (); i ++){
-	            std::cout << "Frame " << i << ":" << std::endl;
+	            LogLine (log_, LOG_DEBUG) << "Frame " << i << ":";
 	            print_frame (F_[i]);
 	        }
-	        std::cout << "-----------End of F sequence information------------" << std::endl;
+	        LogLine (log_, LOG_DEBUG) << "-----------End of F sequence information------------";
 	    }
 	    
 	    inline void print_B (){
-	        std::cout << "-----------B sequence information------------" << std::endl;
+	        LogLine (log_, LOG_DEBUG) << "-----------B sequence information------------";
 	        for (int i = 0; i < B_.size (); i ++){
 	            for (int j = 0; j < B_[i].size (); j ++)
-	                B_[i][j]->print ();
+	                LogLine (log_, LOG_DEBUG) << B_[i][j]->latches ();
 	        }
-	        std::cout << "-----------End of B sequence information------------" << std::endl;
+	        LogLine (log_, LOG_DEBUG) << "-----------End of B sequence information------------";
 	    }
 	    
+	    //the SAT solvers trace to log_ only with LOG_DEBUG, otherwise they do not even test the level
+	    inline Logger* trace_log () {return log_.enabled (LOG_DEBUG) ? &log_ : NULL;}
+	    
 	    inline void print (){
 	        print_F ();
 	        print_B ();
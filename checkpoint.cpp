@@ -0,0 +1,245 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   checkpoint.cpp
+ * Note: Checkpoint log of CAR, see checkpoint.h.
+ *       Format: the header "CARCKPT1" followed by the number of inputs, latches,
+ *       the maximum id, the bad literal and the direction, then the events, each of them
+ *       being a tag byte, the level, the size of the cube and its literals.
+ *       Numbers are LEB128 varints, literals are zigzag encoded.
+ *       A state is referred to by its index in B_ plus one, 0 for none.
+ */
+
+#include "checkpoint.h"
+#include <unistd.h>
+#include <stdio.h>
+#include <iostream>
+using namespace std;
+
+namespace car
+{
+	static const char* CKPT_MAGIC = "CARCKPT1";
+
+	CheckpointLog::CheckpointLog (Model* model, const int bad, const bool forward, const bool states) :
+	    file_ (NULL), forward_ (forward), states_ (states)
+	{
+		//the header identifies the model, the property and the direction
+		buf_ = CKPT_MAGIC;
+		put_uint (model->num_inputs ());
+		put_uint (model->num_latches ());
+		put_uint (model->max_id ());
+		put_uint ((unsigned) ((bad << 1) ^ (bad >> 31)));
+		put_uint ((forward ? 1 : 0) | (states ? 2 : 0));
+		header_ = buf_;
+		buf_.clear ();
+	}
+
+	CheckpointLog::~CheckpointLog ()
+	{
+		if (file_ != NULL)
+			fclose (file_);
+	}
+
+	bool CheckpointLog::open (const string& path, const string& prefix)
+	{
+		//the committed part is written to a new file first, so that resuming
+		//from and checkpointing to the same file never loses the old log
+		string tmp = path + ".tmp";
+		file_ = fopen (tmp.c_str (), "wb");
+		if (file_ == NULL)
+			return false;
+		const string& start = prefix.empty () ? header_ : prefix;
+		if (fwrite (start.data (), 1, start.size (), file_) != start.size () || fflush (file_) != 0
+		    || rename (tmp.c_str (), path.c_str ()) != 0)
+		{
+			fclose (file_);
+			file_ = NULL;
+			return false;
+		}
+		path_ = path;
+		buf_.clear ();
+		return true;
+	}
+
+	bool CheckpointLog::load (const string& path, vector<CheckpointEvent>& events, int& frame_level, string& prefix)
+	{
+		FILE* f = fopen (path.c_str (), "rb");
+		if (f == NULL)
+			return false;
+		string s;
+		char block[65536];
+		size_t n;
+		while ((n = fread (block, 1, sizeof (block), f)) > 0)
+			s.append (block, n);
+		fclose (f);
+		if (s.compare (0, header_.size (), header_) != 0)
+			return false;
+
+		//a preempted run may leave a truncated tail, the events after the last commit are dropped
+		size_t pos = header_.size (), committed = pos, num_committed = 0;
+		char tag;
+		int level;
+		Cube cu;
+		while (get_event (s, pos, tag, level, cu))
+		{
+			events.push_back (CheckpointEvent (tag, level, cu));
+			if (tag == CKPT_COMMIT)
+			{
+				frame_level = level;
+				committed = pos;
+				num_committed = events.size ();
+			}
+		}
+		events.erase (events.begin () + num_committed, events.end ());
+		prefix = s.substr (0, committed);
+		//cubes_ as logged in the prefix, so that they are not logged again
+		for (int i = 0; i < events.size (); i ++)
+		{
+			if (events[i].tag != CKPT_CUBES)
+				continue;
+			if (cubes_.size () < events[i].level+1)
+				cubes_.resize (events[i].level+1);
+			cubes_[events[i].level] = events[i].cube;
+		}
+		return committed > header_.size ();
+	}
+
+	void CheckpointLog::new_frame (const int level, const Cube& cube, const Cube& comm)
+	{
+		put_event (CKPT_CUBES, level, cube);
+		put_event (CKPT_FRAME, 0, comm);
+		if (cubes_.size () < level+1)
+			cubes_.resize (level+1);
+		cubes_[level] = cube_ = cube;
+	}
+
+	void CheckpointLog::add_state (const State* s)
+	{
+		if (!states_)
+			return;
+		State* st = const_cast<State*> (s);
+		Cube cu = st->inputs_vec ();
+		cu.push_back (0);
+		cu.insert (cu.end (), st->s ().begin (), st->s ().end ());
+		put_event (CKPT_STATE, state_index (forward_ ? st->next () : st->pre ()), cu);
+		int n = index_.size ();
+		index_[s] = n;
+	}
+
+	void CheckpointLog::mark_dead (const State* s)
+	{
+		if (states_)
+			put_event (CKPT_KILL, state_index (s), Cube ());
+	}
+
+	void CheckpointLog::add_alive (const State* s)
+	{
+		put_event (CKPT_ALIVE, state_index (s), const_cast<State*> (s)->s ());
+	}
+
+	int CheckpointLog::state_index (const State* s) const
+	{
+		hash_map<const State*, int>::const_iterator it = index_.find (s);
+		return (it == index_.end ()) ? 0 : it->second+1;
+	}
+
+	void CheckpointLog::commit (const int frame_level, const std::vector<Cube>& cubes, const Cube& cube)
+	{
+		if (file_ == NULL)
+			return;
+		//cubes_ is updated in place by the search, cube_ is also cleared and reset within a frame
+		if (cubes_.size () < cubes.size ())
+			cubes_.resize (cubes.size ());
+		for (int i = 0; i < cubes.size (); i ++)
+		{
+			if (cubes[i] != cubes_[i])
+			{
+				put_event (CKPT_CUBES, i, cubes[i]);
+				cubes_[i] = cubes[i];
+			}
+		}
+		if (cube != cube_)
+		{
+			put_event (CKPT_CUBES, cubes.size (), cube);
+			cube_ = cube;
+		}
+		put_event (CKPT_COMMIT, frame_level, Cube ());
+		//one write per frame, synced so that the commit survives the preemption of the machine
+		if (fwrite (buf_.data (), 1, buf_.size (), file_) != buf_.size () || fflush (file_) != 0)
+		{
+			cout << "cannot write the checkpoint " << path_ << ", checkpointing stops" << endl;
+			fclose (file_);
+			file_ = NULL;
+		}
+		else
+			fsync (fileno (file_));
+		buf_.clear ();
+	}
+
+	void CheckpointLog::put_event (const char tag, const int level, const Cube& cu)
+	{
+		buf_.push_back (tag);
+		put_uint (level);
+		put_uint (cu.size ());
+		for (int i = 0; i < cu.size (); i ++)
+			put_uint ((unsigned) ((cu[i] << 1) ^ (cu[i] >> 31)));
+	}
+
+	void CheckpointLog::put_uint (unsigned long long n)
+	{
+		while (n >= 0x80)
+		{
+			buf_.push_back (char ((n & 0x7f) | 0x80));
+			n >>= 7;
+		}
+		buf_.push_back (char (n));
+	}
+
+	bool CheckpointLog::get_uint (const string& s, size_t& pos, unsigned long long& n)
+	{
+		n = 0;
+		for (int shift = 0; pos < s.size () && shift < 64; shift += 7)
+		{
+			unsigned char c = s[pos ++];
+			n |= (unsigned long long) (c & 0x7f) << shift;
+			if ((c & 0x80) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	bool CheckpointLog::get_event (const string& s, size_t& pos, char& tag, int& level, Cube& cu)
+	{
+		if (pos >= s.size ())
+			return false;
+		tag = s[pos ++];
+		unsigned long long l, sz, lit;
+		if (!get_uint (s, pos, l) || !get_uint (s, pos, sz) || sz > s.size ())
+			return false;
+		level = int (l);
+		cu.clear ();
+		for (unsigned long long i = 0; i < sz; i ++)
+		{
+			if (!get_uint (s, pos, lit))
+				return false;
+			unsigned u = unsigned (lit);
+			cu.push_back (int (u >> 1) ^ -int (u & 1));
+		}
+		return true;
+	}
+}
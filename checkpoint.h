@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   checkpoint.h
+ * Note: Append-only binary log of the changes of F_, deads_, cubes_ and comms_,
+ *       so that a preempted run can be resumed (-checkpoint, -resume).
+ *       Events are buffered and written at each frame boundary, followed by a commit
+ *       record carrying the frame level; only committed events are replayed.
+ *       B_ is only logged for forward CAR with dead states, whose dead checks depend
+ *       on the states explored so far; otherwise it is recomputed after resuming.
+ */
+
+#ifndef CHECKPOINT_H
+#define	CHECKPOINT_H
+
+#include "data_structure.h"
+#include "model.h"
+#include "hash_map.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace car
+{
+	enum CheckpointTag
+	{
+		CKPT_CUBE = 'c',   //cube pushed to a frame (level, cube)
+		CKPT_FRAME = 'f',  //frame_ appended to F_ (comm_)
+		CKPT_CLEAR = 'x',  //frame_ cleared
+		CKPT_DEAD = 'd',   //dead cube
+		CKPT_STATE = 's',  //state added to B_ (index of the state it comes from + 1, inputs 0 latches)
+		CKPT_KILL = 'm',   //state marked dead (index + 1)
+		CKPT_ALIVE = 'a',  //state blocked in dead_solver_ after a failed dead check (index + 1, state)
+		CKPT_CUBES = 'u',  //new value of cubes_[level] (cube_ for level == cubes_.size ())
+		CKPT_COMMIT = 'k'  //frame boundary (frame level)
+	};
+
+	struct CheckpointEvent
+	{
+		CheckpointEvent (const char t, const int l, const Cube& cu) : tag (t), level (l), cube (cu) {}
+		char tag;
+		int level;
+		Cube cube;
+	};
+
+	class CheckpointLog
+	{
+	public:
+		//states: whether B_ is logged
+		CheckpointLog (Model* model, const int bad, const bool forward, const bool states);
+		~CheckpointLog ();
+
+		//start the file with prefix, the committed part of a resumed log (empty for a new log).
+		//The events logged before, when replaying that log, are dropped
+		bool open (const std::string& path, const std::string& prefix);
+		//read the committed events (commits included) of a log written for the same model, property
+		//and direction, prefix gets the committed bytes and frame_level the level of the last commit
+		bool load (const std::string& path, std::vector<CheckpointEvent>& events, int& frame_level, std::string& prefix);
+
+		inline void add_cube (const int level, const Cube& cu) {put_event (CKPT_CUBE, level, cu);}
+		//frame_ appended to F_ at level, with cube_ and comm_
+		void new_frame (const int level, const Cube& cube, const Cube& comm);
+		inline void clear_frame () {put_event (CKPT_CLEAR, 0, Cube ()); cube_.clear ();}
+		inline void add_dead (const Cube& cu) {put_event (CKPT_DEAD, 0, cu);}
+		void add_state (const State* s);
+		void mark_dead (const State* s);
+		void add_alive (const State* s);
+		//log cube_ and the entries of cubes_ changed since the last commit, then write everything
+		void commit (const int frame_level, const std::vector<Cube>& cubes, const Cube& cube);
+
+	private:
+		FILE* file_;
+		std::string path_;
+		std::string buf_;  //events since the last commit
+		std::string header_;
+		bool forward_, states_;
+		hash_map<const State*, int> index_;  //index of the states of B_, in the order logged
+		std::vector<Cube> cubes_;  //cubes_ as logged so far
+		Cube cube_;  //cube_ as replayed from the log so far
+
+		void put_event (const char tag, const int level, const Cube& cu);
+		int state_index (const State* s) const;
+		void put_uint (unsigned long long n);
+		static bool get_uint (const std::string& s, size_t& pos, unsigned long long& n);
+		static bool get_event (const std::string& s, size_t& pos, char& tag, int& level, Cube& cu);
+	};
+}
+
+#endif
@@ -0,0 +1,654 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   daemon.cpp
+ * Note: Checking daemon, see daemon.h. The daemon polls the socket, the clients and the
+ *       pipes of the workers. A worker writes the .res file of its check to a temporary
+ *       file made by the daemon, and sends it back as the answer line.
+ */
+
+#include "daemon.h"
+#include "aigreader.h"
+#include "framecache.h"
+#include "portfolio.h"
+#include "resource.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <new>
+using namespace std;
+
+namespace car
+{
+	static const int GRACE = 10;
+	static const int BLOCK = 4096;
+	static const unsigned long long FNV_OFFSET = 14695981039346656037ULL;
+	static const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+	///////////////////////////////////JSON lines//////////////////////////////////
+	//a value of a flat JSON object: strings are unescaped, the other values are kept as written
+	struct JsonValue
+	{
+		bool str;
+		string text;
+	};
+
+	static string json_string (const string& s)
+	{
+		string res = "\"";
+		for (int i = 0; i < s.size (); i ++)
+		{
+			unsigned char ch = s[i];
+			if (ch == '"' || ch == '\\')
+				res += '\\', res += ch;
+			else if (ch == '\n')
+				res += "\\n";
+			else if (ch == '\t')
+				res += "\\t";
+			else if (ch < 0x20)
+			{
+				char buf[8];
+				sprintf (buf, "\\u%04x", ch);
+				res += buf;
+			}
+			else
+				res += ch;
+		}
+		return res + "\"";
+	}
+
+	static void skip_spaces (const string& s, size_t& p)
+	{
+		while (p < s.size () && (s[p] == ' ' || s[p] == '\t' || s[p] == '\r'))
+			p ++;
+	}
+
+	static bool parse_string (const string& s, size_t& p, string& res)
+	{
+		if (p >= s.size () || s[p] != '"')
+			return false;
+		res.clear ();
+		for (p ++; p < s.size () && s[p] != '"'; p ++)
+		{
+			if (s[p] != '\\')
+			{
+				res += s[p];
+				continue;
+			}
+			if (++p >= s.size ())
+				return false;
+			switch (s[p])
+			{
+				case 'n': res += '\n'; break;
+				case 't': res += '\t'; break;
+				case 'r': res += '\r'; break;
+				case 'b': res += '\b'; break;
+				case 'f': res += '\f'; break;
+				case 'u':
+				{
+					//the paths and flags are ASCII
+					if (p+4 >= s.size ())
+						return false;
+					unsigned code = strtoul (s.substr (p+1, 4).c_str (), NULL, 16);
+					if (code >= 0x80)
+						return false;
+					res += (char) code;
+					p += 4;
+					break;
+				}
+				default: res += s[p];
+			}
+		}
+		return p++ < s.size ();
+	}
+
+	static bool parse_object (const string& s, map<string, JsonValue>& values)
+	{
+		size_t p = 0;
+		skip_spaces (s, p);
+		if (p >= s.size () || s[p++] != '{')
+			return false;
+		skip_spaces (s, p);
+		if (p < s.size () && s[p] == '}')
+			p ++;
+		else while (true)
+		{
+			string key;
+			JsonValue v;
+			skip_spaces (s, p);
+			if (!parse_string (s, p, key))
+				return false;
+			skip_spaces (s, p);
+			if (p >= s.size () || s[p++] != ':')
+				return false;
+			skip_spaces (s, p);
+			v.str = (p < s.size () && s[p] == '"');
+			if (v.str)
+			{
+				if (!parse_string (s, p, v.text))
+					return false;
+			}
+			else
+			{
+				//numbers, true, false and null
+				size_t b = p;
+				while (p < s.size () && (isalnum (s[p]) || s[p] == '-' || s[p] == '+' || s[p] == '.'))
+					p ++;
+				if (b == p)
+					return false;
+				v.text = s.substr (b, p-b);
+			}
+			values[key] = v;
+			skip_spaces (s, p);
+			if (p < s.size () && s[p] == ',')
+			{
+				p ++;
+				continue;
+			}
+			if (p >= s.size () || s[p++] != '}')
+				return false;
+			break;
+		}
+		skip_spaces (s, p);
+		return p == s.size ();
+	}
+
+	static bool json_int (const JsonValue& v, long& res)
+	{
+		char* end;
+		res = strtol (v.text.c_str (), &end, 10);
+		return !v.str && !v.text.empty () && *end == '\0';
+	}
+
+	static double now ()
+	{
+		struct timeval tv;
+		gettimeofday (&tv, NULL);
+		return tv.tv_sec + tv.tv_usec / 1000000.0;
+	}
+
+	///////////////////////////////////daemon//////////////////////////////////
+	Daemon::Daemon (const CheckOptions& opts, const int jobs) : opts_ (opts), jobs_ (jobs), uses_ (0), listen_ (-1)
+	{
+		if (jobs_ <= 0)
+			jobs_ = sysconf (_SC_NPROCESSORS_ONLN);
+		if (jobs_ <= 0)
+			jobs_ = 1;
+	}
+
+	Daemon::~Daemon ()
+	{
+		for (map<unsigned long long, Design>::iterator it = designs_.begin (); it != designs_.end (); it ++)
+			delete it->second.model;
+	}
+
+	bool Daemon::run (const string& path, string& error)
+	{
+		signal (SIGPIPE, SIG_IGN);
+		if (path == "-")
+			clients_[0] = "";
+		else
+		{
+			struct sockaddr_un addr;
+			if (path.size () >= sizeof (addr.sun_path))
+			{
+				error = "socket path too long";
+				return false;
+			}
+			memset (&addr, 0, sizeof (addr));
+			addr.sun_family = AF_UNIX;
+			strcpy (addr.sun_path, path.c_str ());
+			unlink (path.c_str ());
+			listen_ = socket (AF_UNIX, SOCK_STREAM, 0);
+			if (listen_ < 0 || bind (listen_, (struct sockaddr*) &addr, sizeof (addr)) != 0 || listen (listen_, 16) != 0)
+			{
+				error = string ("can not listen on '") + path + "': " + strerror (errno);
+				if (listen_ >= 0)
+					close (listen_);
+				return false;
+			}
+			path_ = path;
+		}
+
+		//stdin is served until it ends, a socket until the daemon is interrupted
+		while (!Resources::interrupted () && (listen_ >= 0 || !clients_.empty () || !pending_.empty () || !workers_.empty ()))
+		{
+			vector<struct pollfd> fds;
+			struct pollfd pfd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			if (listen_ >= 0)
+			{
+				pfd.fd = listen_;
+				fds.push_back (pfd);
+			}
+			for (map<int, string>::iterator it = clients_.begin (); it != clients_.end (); it ++)
+			{
+				pfd.fd = it->first;
+				fds.push_back (pfd);
+			}
+			for (int i = 0; i < workers_.size (); i ++)
+			{
+				pfd.fd = workers_[i].pipe;
+				fds.push_back (pfd);
+			}
+			if (poll (fds.empty () ? NULL : &fds[0], fds.size (), 100) < 0 && errno != EINTR)
+				break;
+
+			for (int i = 0; i < fds.size (); i ++)
+			{
+				if (fds[i].revents == 0)
+					continue;
+				int fd = fds[i].fd;
+				char buf[BLOCK];
+				if (fd == listen_)
+				{
+					int client = accept (listen_, NULL, NULL);
+					if (client >= 0)
+						clients_[client] = "";
+					continue;
+				}
+				int w = 0;
+				while (w < workers_.size () && workers_[w].pipe != fd)
+					w ++;
+				ssize_t n = read (fd, buf, BLOCK);
+				if (w < workers_.size ())
+				{
+					if (n > 0)
+						workers_[w].answer.append (buf, n);
+					else
+					{
+						int status = 0;
+						waitpid (workers_[w].pid, &status, 0);
+						finish (workers_[w], status);
+						workers_.erase (workers_.begin () + w);
+					}
+				}
+				else if (n > 0)
+				{
+					string& rest = clients_[fd];
+					rest.append (buf, n);
+					size_t end;
+					while ((end = rest.find ('\n')) != string::npos)
+					{
+						string line = rest.substr (0, end);
+						rest.erase (0, end+1);
+						serve_line (fd, line);
+					}
+				}
+				else
+					close_client (fd);
+			}
+			start_workers ();
+
+			//the workers over time, their answer is written when their pipe ends
+			double t = now ();
+			for (int i = 0; i < workers_.size (); i ++)
+			{
+				int timeout = workers_[i].request.opts.timeout;
+				if (timeout > 0 && !workers_[i].killed && t - workers_[i].start > timeout + GRACE)
+				{
+					kill (workers_[i].pid, SIGKILL);
+					workers_[i].killed = true;
+				}
+			}
+		}
+
+		for (int i = 0; i < workers_.size (); i ++)
+		{
+			kill (workers_[i].pid, SIGKILL);
+			waitpid (workers_[i].pid, NULL, 0);
+			close (workers_[i].pipe);
+			unlink (workers_[i].res_file.c_str ());
+		}
+		workers_.clear ();
+		while (!clients_.empty ())
+			close_client (clients_.begin ()->first);
+		if (listen_ >= 0)
+		{
+			close (listen_);
+			unlink (path_.c_str ());
+		}
+		return true;
+	}
+
+	void Daemon::serve_line (const int client, const string& line)
+	{
+		if (line.find_first_not_of (" \t\r") == string::npos)
+			return;
+		map<string, JsonValue> values;
+		Request req;
+		req.client = client;
+		req.id = "null";
+		req.property = 0;
+		req.opts = opts_;
+		if (!parse_object (line, values))
+		{
+			answer (client, "{\"id\": null, \"error\": \"invalid JSON object\"}");
+			return;
+		}
+		map<string, JsonValue>::iterator it = values.find ("id");
+		if (it != values.end ())
+			req.id = it->second.str ? json_string (it->second.text) : it->second.text;
+
+		string error;
+		long n;
+		if ((it = values.find ("file")) == values.end () || !it->second.str || it->second.text.empty ())
+			error = "file is missing";
+		else
+			req.file = it->second.text;
+		if ((it = values.find ("property")) != values.end ())
+		{
+			if (!json_int (it->second, n) || n < 0)
+				error = "invalid property";
+			req.property = n;
+		}
+		if ((it = values.find ("timeout")) != values.end ())
+		{
+			if (!json_int (it->second, n) || n <= 0)
+				error = "invalid timeout";
+			req.opts.timeout = n;
+		}
+		if ((it = values.find ("memout")) != values.end ())
+		{
+			if (!json_int (it->second, n) || n <= 0)
+				error = "invalid memout";
+			req.opts.memout = n;
+		}
+		if ((it = values.find ("flags")) != values.end ())
+		{
+			istringstream in (it->second.text);
+			vector<string> words;
+			string word;
+			while (in >> word)
+				words.push_back (word);
+			vector<char*> argv;
+			for (int i = 0; i < words.size (); i ++)
+				argv.push_back (&words[i][0]);
+			for (int i = 0; i < argv.size () && error.empty (); i ++)
+			{
+				bool bad;
+				if (!req.opts.parse (argv.size (), &argv[0], i, bad) || bad)
+					error = "invalid flag " + words[i];
+			}
+			//the requests of a design would share the checkpoint
+			if (req.opts.uses_checkpoint ())
+				error = "-checkpoint and -resume are not served";
+			if (!req.opts.portfolio_configs.empty () || req.opts.schedule > 0)
+				error = "-portfolio-config and -schedule are not served";
+			req.opts.verbose = false;
+		}
+		if (!error.empty ())
+			answer (client, "{\"id\": " + req.id + ", \"error\": " + json_string (error) + "}");
+		else
+			pending_.push_back (req);
+	}
+
+	//the Model of file, parsed once per content, and the key of its Design
+	Daemon::Design* Daemon::design (const string& file, unsigned long long& key, bool& cached, string& error)
+	{
+		unsigned long long h = FNV_OFFSET;
+		int fd = open (file.c_str (), O_RDONLY);
+		if (fd < 0)
+		{
+			error = "can not read '" + file + "'";
+			return NULL;
+		}
+		char buf[BLOCK];
+		ssize_t n;
+		while ((n = read (fd, buf, BLOCK)) > 0)
+		{
+			for (int i = 0; i < n; i ++)
+				h = (h ^ (unsigned char) buf[i]) * FNV_PRIME;
+		}
+		close (fd);
+		key = h;
+		map<unsigned long long, Design>::iterator it = designs_.find (h);
+		cached = (it != designs_.end ());
+		if (cached)
+		{
+			it->second.used = ++ uses_;
+			return &it->second;
+		}
+
+		aiger* aig = aiger_init ();
+		if (!read_aiger (aig, file.c_str (), error))
+		{
+			aiger_reset (aig);
+			return NULL;
+		}
+		if (!aiger_is_reencoded (aig))
+			aiger_reencode (aig);
+		Design d;
+		try {
+			d.model = new Model (aig);
+		}
+		catch (std::bad_alloc& e) {
+			aiger_reset (aig);
+			error = "memory limit";
+			return NULL;
+		}
+		d.hash = FrameCache::hash (aig);
+		d.used = ++ uses_;
+		aiger_reset (aig);
+		if (designs_.size () >= DESIGNS)
+			evict_design ();
+		return &(designs_[h] = d);
+	}
+
+	//free the least recently requested Model that no worker is checking (a worker has its own
+	//copy since the fork, but its design is likely to be requested again)
+	void Daemon::evict_design ()
+	{
+		map<unsigned long long, Design>::iterator oldest = designs_.end ();
+		for (map<unsigned long long, Design>::iterator it = designs_.begin (); it != designs_.end (); it ++)
+		{
+			bool running = false;
+			for (int i = 0; i < workers_.size () && !running; i ++)
+				running = (workers_[i].design == it->first);
+			if (!running && (oldest == designs_.end () || it->second.used < oldest->second.used))
+				oldest = it;
+		}
+		if (oldest == designs_.end ())
+			return;
+		delete oldest->second.model;
+		designs_.erase (oldest);
+	}
+
+	void Daemon::start_workers ()
+	{
+		while (workers_.size () < jobs_ && !pending_.empty ())
+		{
+			Request req = pending_.front ();
+			pending_.pop_front ();
+			bool cached;
+			unsigned long long key = 0;
+			string error;
+			Design* d = design (req.file, key, cached, error);
+			if (d != NULL && req.property >= d->model->num_outputs ())
+				error = "property exceeds the outputs";
+			int fds[2], fd = -1;
+			char res_file[] = "/tmp/simplecar-daemon-XXXXXX";
+			if (error.empty () && (pipe (fds) != 0 || (fd = mkstemp (res_file)) < 0))
+				error = "can not create a worker";
+			if (fd >= 0)
+				close (fd);
+			if (!error.empty ())
+			{
+				answer (req.client, "{\"id\": " + req.id + ", \"error\": " + json_string (error) + "}");
+				continue;
+			}
+			pid_t pid = fork ();
+			if (pid == 0)
+			{
+				close (fds[0]);
+				check (req, *d, cached, res_file, fds[1]);
+			}
+			close (fds[1]);
+			if (pid < 0)
+			{
+				close (fds[0]);
+				unlink (res_file);
+				answer (req.client, "{\"id\": " + req.id + ", \"error\": \"can not create a worker\"}");
+				continue;
+			}
+			Worker w;
+			w.pid = pid;
+			w.pipe = fds[0];
+			w.request = req;
+			w.res_file = res_file;
+			w.design = key;
+			w.start = now ();
+			w.killed = false;
+			workers_.push_back (w);
+		}
+	}
+
+	//in the worker: check and write the answer without the time to out
+	void Daemon::check (const Request& req, const Design& d, const bool cached, const char* res_file_name, const int out)
+	{
+		if (listen_ >= 0)
+			close (listen_);
+		for (map<int, string>::iterator it = clients_.begin (); it != clients_.end (); it ++)
+			close (it->first);
+		freopen ("/dev/null", "w", stdout);
+
+		Resources::set_time_limit (req.opts.timeout);
+		if (req.opts.memout > 0)
+			Resources::set_memory_limit (req.opts.memout);
+		Resources::set_sat_budgets (req.opts.conflict_budget, req.opts.propagation_budget);
+
+		ofstream res_file (res_file_name);
+		Statistics stats;
+		if (req.opts.portfolio)
+		{
+			Portfolio* p = new Portfolio (d.model, req.opts, stats, NULL);
+			p->set_property (req.property);
+			if (!req.opts.cache_dir.empty ())
+				p->set_cache (req.opts.cache_dir, d.hash);
+			p->check (res_file);
+		}
+		else
+		{
+			Checker* ch = req.opts.new_checker (d.model, stats, NULL);
+			ch->set_property (req.property);
+			if (!req.opts.cache_dir.empty ())
+				ch->set_cache (req.opts.cache_dir, d.hash);
+			ch->check (res_file);
+		}
+		res_file.close ();
+
+		//the .res file: verdict, property, the witness and "."
+		ifstream in (res_file_name);
+		string verdict, line;
+		getline (in, verdict);
+		getline (in, line);
+		ostringstream os;
+		os << "\"file\": " << json_string (req.file) << ", \"property\": " << req.property << ", \"verdict\": \""
+		   << (verdict == "0" ? "safe" : (verdict == "1" ? "unsafe" : "unknown")) << "\", \"cached\": "
+		   << (cached ? "true" : "false");
+		if (req.opts.evidence && verdict == "1")
+		{
+			os << ", \"witness\": [";
+			bool first = true;
+			while (getline (in, line) && line != ".")
+			{
+				os << (first ? "" : ", ") << json_string (line);
+				first = false;
+			}
+			os << "]";
+		}
+		in.close ();
+		string res = os.str ();
+		for (size_t done = 0; done < res.size (); )
+		{
+			ssize_t n = write (out, res.c_str () + done, res.size () - done);
+			if (n <= 0)
+				break;
+			done += n;
+		}
+		_exit (0);
+	}
+
+	void Daemon::finish (Worker& w, const int status)
+	{
+		close (w.pipe);
+		unlink (w.res_file.c_str ());
+		ostringstream os;
+		os << "{\"id\": " << w.request.id << ", ";
+		if (!w.answer.empty () && WIFEXITED (status) && WEXITSTATUS (status) == 0)
+		{
+			os.setf (ios::fixed);
+			os.precision (3);
+			os << w.answer << ", \"time\": " << (now () - w.start) << "}";
+		}
+		else if (w.killed)
+			os << "\"file\": " << json_string (w.request.file) << ", \"property\": " << w.request.property << ", \"verdict\": \"unknown\", \"error\": \"killed over time\"}";
+		else
+			os << "\"error\": \"the check failed\"}";
+		answer (w.request.client, os.str ());
+	}
+
+	void Daemon::answer (const int client, const string& line)
+	{
+		//stdin is answered on stdout, a client which left is not answered
+		int fd = (client == 0) ? 1 : client;
+		if (client != 0 && clients_.find (client) == clients_.end ())
+			return;
+		string s = line + "\n";
+		for (size_t done = 0; done < s.size (); )
+		{
+			ssize_t n = write (fd, s.c_str () + done, s.size () - done);
+			if (n <= 0)
+				break;
+			done += n;
+		}
+	}
+
+	//the answers of its requests are dropped, the fd may be given to a new client
+	void Daemon::close_client (const int client)
+	{
+		if (client != 0)
+			close (client);
+		clients_.erase (client);
+		if (client == 0)
+			return;
+		for (int i = 0; i < pending_.size (); i ++)
+		{
+			if (pending_[i].client == client)
+				pending_[i].client = -1;
+		}
+		for (int i = 0; i < workers_.size (); i ++)
+		{
+			if (workers_[i].request.client == client)
+				workers_[i].request.client = -1;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   daemon.h
+ * Note: Checking daemon (-daemon), serving JSON-line requests on a Unix socket, or on
+ *       stdin and stdout for "-". A request is an object
+ *         {"id": <any>, "file": <aiger file>, "property": <output index>, "flags": <options>,
+ *          "timeout": <s>, "memout": <MB>}
+ *       where only file is required, and flags are the command line options of a check, added
+ *       to the options of the daemon. Each request is answered by one line when its check ends
+ *         {"id": <any>, "file": ..., "property": ..., "verdict": "safe|unsafe|unknown",
+ *          "time": <s>, "cached": <bool>, "witness": [<latches>, <inputs>, ...]}
+ *       or {"id": <any>, "error": <message>}. The answers of concurrent requests may come
+ *       in any order.
+ *       The Models are parsed once and kept by the hash of their file, DESIGNS of them at
+ *       most: beyond, the least recently requested one that no running check uses is freed
+ *       (each edit of a design is a new file content, and so a new Model). A check runs in a
+ *       worker forked from the daemon, which shares the Model with the daemon and the other
+ *       workers, and whose limits (Resources) are its own. At most jobs checks run at the
+ *       same time, the other requests wait.
+ */
+
+#ifndef DAEMON_H
+#define	DAEMON_H
+
+#include "options.h"
+#include "model.h"
+#include <sys/types.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace car
+{
+	class Daemon
+	{
+	public:
+		//jobs checks at most at the same time, 0 means one per CPU
+		Daemon (const CheckOptions& opts, const int jobs);
+		~Daemon ();
+
+		//serve on the Unix socket path, or stdin and stdout for "-", until stdin ends or the
+		//daemon is interrupted. Return false (with error) if the socket cannot be opened
+		bool run (const std::string& path, std::string& error);
+
+	private:
+		//Models kept by designs_, the least recently requested are freed beyond
+		static const int DESIGNS = 16;
+
+		struct Design
+		{
+			Model* model;
+			unsigned long long hash;  //FrameCache::hash, for -cache
+			unsigned long long used;  //uses_ at its last request
+		};
+
+		struct Request
+		{
+			int client;  //fd the answer is written to, 0 for stdin and -1 if the client left
+			std::string id;  //JSON value, as written
+			std::string file;
+			int property;
+			CheckOptions opts;
+		};
+
+		struct Worker
+		{
+			pid_t pid;
+			int pipe;  //the answer of the worker
+			std::string answer;
+			std::string res_file;  //of the check, removed by the daemon
+			unsigned long long design;  //key of its Design in designs_
+			Request request;
+			double start;
+			bool killed;
+		};
+
+		CheckOptions opts_;
+		int jobs_;
+		std::map<unsigned long long, Design> designs_;  //by the hash of the file
+		unsigned long long uses_;  //requests given a Design
+		std::deque<Request> pending_;
+		std::vector<Worker> workers_;
+		std::map<int, std::string> clients_;  //fd and its unfinished line
+		int listen_;
+		std::string path_;
+
+		void serve_line (const int client, const std::string& line);
+		Design* design (const std::string& file, unsigned long long& key, bool& cached, std::string& error);
+		void evict_design ();
+		void start_workers ();
+		void check (const Request& req, const Design& d, const bool cached, const char* res_file_name, const int out);
+		void finish (Worker& w, const int status);
+		void answer (const int client, const std::string& line);
+		void close_client (const int client);
+	};
+}
+
+#endif
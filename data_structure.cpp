@@ -33,8 +33,9 @@
  namespace car
  {
  
-    State::State (const State *s, const Assignment& inputs, const Assignment& latches, const bool forward, const bool last) 
+    State::State (StateContext* ctx, const State *s, const Assignment& inputs, const Assignment& latches, const bool forward, const bool last) 
  	{
+ 		ctx_ = ctx;
  		if (forward)
  		{
  			pre_ = NULL;
@@ -54,7 +55,7 @@
  		}
  		detect_dead_start_ = 0;
  		init_ = false;
- 		id_ = id_counter_++;
+ 		id_ = ctx_->new_id ();
  		if (s == NULL)
  		    dep_ = 0;
  		else
@@ -68,7 +69,7 @@
 	{
 		for (int i = 0; i < cu.size (); i ++)
 		{
-			int index = abs(cu[i]) - num_inputs_ - 1;
+			int index = abs(cu[i]) - ctx_->num_inputs () - 1;
 			assert (index >= 0);
 			if (s_[index] != cu[i])
 				return false;
@@ -81,7 +82,7 @@
 		Cube res;
 		for (int i = 0; i < cu.size (); i ++)
 		{
-			int index = abs(cu[i]) - num_inputs_ - 1;
+			int index = abs(cu[i]) - ctx_->num_inputs () - 1;
 			assert (index >= 0);
 			if (s_[index] == cu[i])
 				res.push_back (cu[i]);
@@ -89,7 +90,7 @@
 		return res;
 	}
  	
- 	void State::print_evidence (bool forward, ofstream& out)
+ 	void State::print_evidence (bool forward, ostream& out)
  	{
  		State* nx = this;
 	    if (forward)
@@ -163,11 +164,11 @@
  		string res = "";
  		//int input_size = inputs_.size ();
  		int j = 0;
- 		for (int i = 0; i < num_latches_; i ++)
+ 		for (int i = 0; i < ctx_->num_latches (); i ++)
  		{
  			if (j == s_.size ())
  				res += "x";
- 			else if (num_inputs_+i+1 < abs (s_[j]))
+ 			else if (ctx_->num_inputs ()+i+1 < abs (s_[j]))
  				res += "x";
  			else
  			{
@@ -178,16 +179,6 @@
  		return res;
  	}
  	
- 	int State::num_inputs_ = 0;
- 	int State::num_latches_ = 0;
- 	int State::id_counter_ = 1;
- 	
- 	void State::set_num_inputs_and_latches (const int n1, const int n2) 
- 	{
- 		num_inputs_ = n1;
- 	    num_latches_ = n2;
- 	}
- 	
  	
 }
  		
@@ -37,15 +37,41 @@
  	typedef std::vector<Cube> Frame;
  	typedef std::vector<Frame> Fsequence;
  	
+ 	//for hash_set<Cube, CubeHash>, the JS hash of the literals
+ 	struct CubeHash
+ 	{
+ 		inline size_t operator() (const Cube& cu) const {
+ 			size_t h = 1315423911;
+ 			for (int i = 0; i < cu.size (); i ++)
+ 				h ^= (h << 5) + cu[i] + (h >> 2);
+ 			return h;
+ 		}
+ 	};
+ 	
+ 	//sizes of the model and the id counter shared by the states of one checker
+ 	class StateContext
+ 	{
+ 	public:
+ 		StateContext (const int num_inputs, const int num_latches) : num_inputs_ (num_inputs), num_latches_ (num_latches), id_counter_ (1) {}
+ 		
+ 		inline int num_inputs () const {return num_inputs_;}
+ 		inline int num_latches () const {return num_latches_;}
+ 		inline int new_id () {return id_counter_++;}
+ 	private:
+ 		int num_inputs_;
+ 		int num_latches_;
+ 		int id_counter_;
+ 	};
+ 	
  	//state 
  	class State 
  	{
  	public:
- 	    State (const Assignment& latches) : s_ (latches), pre_ (NULL), next_ (NULL), dead_ (false), added_to_dead_solver_ (false) {}
+ 	    State (StateContext* ctx, const Assignment& latches) : ctx_ (ctx), s_ (latches), pre_ (NULL), next_ (NULL), dead_ (false), added_to_dead_solver_ (false) {}
 
- 		State (const State *s, const Assignment& inputs, const Assignment& latches, const bool forward, const bool last = false); 
+ 		State (StateContext* ctx, const State *s, const Assignment& inputs, const Assignment& latches, const bool forward, const bool last = false); 
  		
- 		State (State *s): pre_ (s->pre_), next_(s->next_), s_(s->s_), inputs_(s->inputs_), last_inputs_(s->last_inputs_), 
+ 		State (State *s): ctx_ (s->ctx_), pre_ (s->pre_), next_(s->next_), s_(s->s_), inputs_(s->inputs_), last_inputs_(s->last_inputs_), 
  		init_ (s->init_), id_ (s->id_), dep_ (s->dep_), dead_ (false), added_to_dead_solver_ (false) {}
 
  		~State () {}
@@ -64,7 +90,7 @@
  		
  		inline void print () { std::cout << latches () << std::endl;}
  		
- 		void print_evidence (bool forward, std::ofstream&);
+ 		void print_evidence (bool forward, std::ostream&);
  		
  		inline int depth () {return dep_;}
  		inline Assignment& s () {return s_;}
@@ -82,7 +108,6 @@
  		
  		inline void set_s (Cube &cube) {s_ = cube;}
  		inline void set_next (State* nx) {next_ = nx;}
- 		static void set_num_inputs_and_latches (const int n1, const int n2); 
  		
  		inline void set_nexts (std::vector<int>& nexts) {nexts_ = nexts; computed_next_ = true;}
  		inline std::vector<int>& nexts () {return nexts_;}
@@ -99,6 +124,7 @@
  		inline void set_added_to_dead_solver (bool val) {added_to_dead_solver_ = val;}
  		inline bool added_to_dead_solver () {return added_to_dead_solver_;}
  	private:
+ 		StateContext* ctx_;
  	//s_ contains all latches, but if the value of latch l is not cared, assign it to -1.
  		Assignment s_;
  		State* next_;
@@ -121,10 +147,6 @@
  		
  		
  		int detect_dead_start_; //to store the start position to check whether it is a dead state
- 		
- 		static int num_inputs_;
- 		static int num_latches_;
- 		static int id_counter_;
  	};
  	
  	typedef std::vector<std::vector<State*> > Bsequence;
@@ -0,0 +1,192 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   deadstore.cpp
+ * Note: See deadstore.h.
+ */
+
+#include "deadstore.h"
+#include <algorithm>
+#include <limits.h>
+using namespace std;
+
+namespace car
+{
+	void DeadStore::add (const Cube& cu)
+	{
+		if (cu.empty ())
+			clear ();
+		else
+		{
+			//the cubes containing cu are in the occurrence list of each literal of cu
+			int best = code (cu[0]);
+			for (int i = 1; i < cu.size (); i ++)
+			{
+				int c = code (cu[i]);
+				if (c >= occurs_.size () || (best < occurs_.size () && occurs_[c].size () < occurs_[best].size ()))
+					best = c;
+			}
+			if (best < occurs_.size ())
+			{
+				mark (cu);
+				vector<int>& occ = occurs_[best];
+				for (int i = 0; i < occ.size (); i ++)
+				{
+					int id = occ[i];
+					if (!alive_[id] || cubes_[id].size () < cu.size ())
+						continue;
+					int n = 0;
+					for (int j = 0; j < cubes_[id].size (); j ++)
+						if (marked (cubes_[id][j]))
+							n ++;
+					if (n == cu.size ())
+					{
+						alive_[id] = false;
+						alive_num_ --;
+					}
+				}
+			}
+		}
+		insert (cu);
+		if (cubes_.size () > 64 && cubes_.size () > 2 * alive_num_)
+			compact ();
+	}
+
+	void DeadStore::assign (const vector<Cube>& cubes)
+	{
+		clear ();
+		for (int i = 0; i < cubes.size (); i ++)
+			insert (cubes[i]);
+	}
+
+	void DeadStore::clear ()
+	{
+		cubes_.clear ();
+		alive_.clear ();
+		occurs_.clear ();
+		watches_.clear ();
+		alive_num_ = 0;
+		last_ = -1;
+		empty_ = -1;
+	}
+
+	void DeadStore::swap (DeadStore& other)
+	{
+		cubes_.swap (other.cubes_);
+		alive_.swap (other.alive_);
+		occurs_.swap (other.occurs_);
+		watches_.swap (other.watches_);
+		std::swap (alive_num_, other.alive_num_);
+		std::swap (last_, other.last_);
+		std::swap (empty_, other.empty_);
+	}
+
+	const Cube* DeadStore::covering (const Cube& st)
+	{
+		if (alive_num_ == 0)
+			return NULL;
+		if (empty_ >= 0)
+			return &cubes_[empty_];
+		mark (st);
+		for (int i = 0; i < st.size (); i ++)
+		{
+			int c = code (st[i]);
+			if (c >= watches_.size ())
+				continue;
+			vector<int>& ws = watches_[c];
+			for (int k = 0; k < ws.size (); k ++)
+			{
+				int id = ws[k];
+				if (!alive_[id])
+				{
+					//drop it from the list on the way
+					ws[k --] = ws.back ();
+					ws.pop_back ();
+					continue;
+				}
+				const Cube& cu = cubes_[id];
+				int j = 0;
+				while (j < cu.size () && marked (cu[j]))
+					j ++;
+				if (j == cu.size ())
+					return &cu;
+			}
+		}
+		return NULL;
+	}
+
+	vector<Cube> DeadStore::cubes () const
+	{
+		vector<Cube> res;
+		res.reserve (alive_num_);
+		for (int i = 0; i < cubes_.size (); i ++)
+			if (alive_[i])
+				res.push_back (cubes_[i]);
+		return res;
+	}
+
+	void DeadStore::mark (const Cube& cu)
+	{
+		if (stamp_ == INT_MAX)
+		{
+			fill (marks_.begin (), marks_.end (), 0);
+			stamp_ = 0;
+		}
+		stamp_ ++;
+		for (int i = 0; i < cu.size (); i ++)
+		{
+			int c = code (cu[i]);
+			if (c >= marks_.size ())
+				marks_.resize (c+1, 0);
+			marks_[c] = stamp_;
+		}
+	}
+
+	//watch the literal with the shortest watch list
+	void DeadStore::insert (const Cube& cu)
+	{
+		int id = cubes_.size ();
+		cubes_.push_back (cu);
+		alive_.push_back (true);
+		alive_num_ ++;
+		last_ = id;
+		int watch = -1;
+		for (int i = 0; i < cu.size (); i ++)
+		{
+			int c = code (cu[i]);
+			if (c >= occurs_.size ())
+			{
+				occurs_.resize (c+1);
+				watches_.resize (c+1);
+			}
+			occurs_[c].push_back (id);
+			if (watch == -1 || watches_[c].size () < watches_[watch].size ())
+				watch = c;
+		}
+		if (watch == -1)
+			empty_ = id;  //it covers every state
+		else
+			watches_[watch].push_back (id);
+	}
+
+	void DeadStore::compact ()
+	{
+		//the cube added last is alive, so it stays the last one
+		assign (cubes ());
+	}
+}
@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   deadstore.h
+ * Note: The dead cubes of -dead, indexed for the query "is this state in some dead cube".
+ *       Each cube is watched by one of its literals, so a query only visits the cubes watched
+ *       by the literals of the state. A cube subsumed by a new one is dropped through the
+ *       occurrence lists of the new cube's literals, and the lists are compacted when the
+ *       dropped cubes outnumber the others.
+ */
+
+#ifndef DEAD_STORE_H
+#define	DEAD_STORE_H
+
+#include "data_structure.h"
+#include <vector>
+
+namespace car
+{
+	class DeadStore
+	{
+	public:
+		DeadStore () : alive_num_ (0), last_ (-1), empty_ (-1), stamp_ (0) {}
+
+		//add cu, and drop the cubes which contain it
+		void add (const Cube& cu);
+		//add the cubes as they are, without subsumption
+		void assign (const std::vector<Cube>& cubes);
+		void clear ();
+		void swap (DeadStore& other);
+
+		//a cube whose literals are all in st, NULL if none
+		const Cube* covering (const Cube& st);
+
+		inline bool empty () const {return alive_num_ == 0;}
+		inline int size () const {return alive_num_;}
+		//the cube added last, must not be empty ()
+		inline const Cube& last () const {return cubes_[last_];}
+		//the cubes in the order they were added
+		std::vector<Cube> cubes () const;
+
+	private:
+		std::vector<Cube> cubes_;
+		std::vector<bool> alive_;
+		std::vector<std::vector<int> > occurs_;  //cubes by each of their literals
+		std::vector<std::vector<int> > watches_;  //cubes by their watched literal
+		int alive_num_;
+		int last_;
+		int empty_;  //the empty cube, if any
+		std::vector<int> marks_;  //of the literals of the current query, by stamp_
+		int stamp_;
+
+		static inline int code (const int lit) {return lit > 0 ? 2*lit : -2*lit+1;}
+		void mark (const Cube& cu);
+		inline bool marked (const int lit) const {
+			int c = code (lit);
+			return c < marks_.size () && marks_[c] == stamp_;
+		}
+		void insert (const Cube& cu);
+		void compact ();
+	};
+}
+
+#endif
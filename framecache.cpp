@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   framecache.cpp
+ * Note: Frame cache, see framecache.h.
+ *       File name: car-<f|b>-<inputs>-<latches>-<key>.frames
+ *       Format: "carcache 1 <safe>", then one line "c <level> <literals> 0" per cube of F_
+ *       and one line "d <literals> 0" per dead cube.
+ */
+
+#include "framecache.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+using namespace std;
+
+namespace car
+{
+	static const unsigned long long FNV_OFFSET = 14695981039346656037ULL;
+	static const unsigned long long FNV_PRIME = 1099511628211ULL;
+	static const int MAX_LEVEL = 1 << 20;
+
+	static int hash_put (char ch, void* state)
+	{
+		unsigned long long* h = (unsigned long long*) state;
+		*h = (*h ^ (unsigned char) ch) * FNV_PRIME;
+		return (unsigned char) ch;
+	}
+
+	unsigned long long FrameCache::hash (aiger* aig)
+	{
+		unsigned long long h = FNV_OFFSET;
+		aiger_strip_symbols_and_comments (aig);
+		aiger_write_generic (aig, aiger_binary_mode, &h, hash_put);
+		return h;
+	}
+
+	FrameCache::FrameCache (const string& dir, const unsigned long long design, Model* model, const int bad, const bool forward) :
+	    dir_ (dir), model_ (model)
+	{
+		//the property and the direction are part of the key
+		unsigned long long key = design;
+		key = (key ^ (unsigned) bad) * FNV_PRIME;
+		key = (key ^ (forward ? 1 : 0)) * FNV_PRIME;
+		ostringstream os;
+		os << "car-" << (forward ? "f" : "b") << "-" << model->num_inputs () << "-" << model->num_latches () << "-";
+		prefix_ = os.str ();
+		os << hex << key << ".frames";
+		file_ = dir_ + "/" + os.str ();
+	}
+
+	CacheMatch FrameCache::load (vector<Frame>& frames, vector<Cube>& deads, bool& safe)
+	{
+		if (read (file_, frames, deads, safe))
+			return CACHE_EXACT;
+		string near = near_file ();
+		if (!near.empty () && read (near, frames, deads, safe))
+			return CACHE_NEAR;
+		return CACHE_NONE;
+	}
+
+	bool FrameCache::save (const vector<Frame>& frames, const vector<Cube>& deads, const bool safe)
+	{
+		//written aside and renamed, for the runs sharing the directory
+		ostringstream os;
+		os << file_ << "." << getpid () << ".tmp";
+		string tmp = os.str ();
+		ofstream out (tmp.c_str ());
+		if (!out)
+			return false;
+		out << "carcache 1 " << (safe ? 1 : 0) << endl;
+		for (int i = 0; i < frames.size (); i ++)
+		{
+			for (int j = 0; j < frames[i].size (); j ++)
+			{
+				out << "c " << i;
+				for (int k = 0; k < frames[i][j].size (); k ++)
+					out << " " << frames[i][j][k];
+				out << " 0" << endl;
+			}
+		}
+		for (int i = 0; i < deads.size (); i ++)
+		{
+			out << "d";
+			for (int k = 0; k < deads[i].size (); k ++)
+				out << " " << deads[i][k];
+			out << " 0" << endl;
+		}
+		out.close ();
+		if (!out || rename (tmp.c_str (), file_.c_str ()) != 0)
+		{
+			remove (tmp.c_str ());
+			return false;
+		}
+		return true;
+	}
+
+	bool FrameCache::read (const string& path, vector<Frame>& frames, vector<Cube>& deads, bool& safe)
+	{
+		ifstream in (path.c_str ());
+		string magic;
+		int version, sf;
+		if (!(in >> magic >> version >> sf) || magic != "carcache" || version != 1)
+			return false;
+		frames.clear ();
+		deads.clear ();
+		safe = (sf == 1);
+		//a file with other variables than the latches is not from a design with these latches
+		int lo = model_->num_inputs ()+1, hi = model_->num_inputs ()+model_->num_latches ();
+		string tag;
+		while (in >> tag)
+		{
+			int level = 0, lit;
+			if (tag == "c" && !(in >> level))
+				return false;
+			else if (tag != "c" && tag != "d")
+				return false;
+			Cube cu;
+			while ((in >> lit) && lit != 0)
+			{
+				if (abs (lit) < lo || abs (lit) > hi)
+					return false;
+				cu.push_back (lit);
+			}
+			if (!in || level < 0 || level > MAX_LEVEL)
+				return false;
+			if (tag == "d")
+			{
+				if (!cu.empty ())
+					deads.push_back (cu);
+			}
+			else
+			{
+				if (frames.size () <= level)
+					frames.resize (level+1);
+				frames[level].push_back (cu);
+			}
+		}
+		return !frames.empty ();
+	}
+
+	//the last file written for a design with the same inputs, latches and direction
+	string FrameCache::near_file () const
+	{
+		DIR* d = opendir (dir_.c_str ());
+		if (d == NULL)
+			return "";
+		string res;
+		time_t last = 0;
+		struct dirent* e;
+		while ((e = readdir (d)) != NULL)
+		{
+			string name = e->d_name;
+			if (name.compare (0, prefix_.size (), prefix_) != 0 || name.size () < 7
+			    || name.compare (name.size ()-7, 7, ".frames") != 0)
+				continue;
+			string path = dir_ + "/" + name;
+			struct stat st;
+			if (path != file_ && stat (path.c_str (), &st) == 0 && st.st_mtime >= last)
+			{
+				last = st.st_mtime;
+				res = path;
+			}
+		}
+		closedir (d);
+		return res;
+	}
+}
@@ -0,0 +1,64 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   framecache.h
+ * Note: Directory of the frames of previous runs (-cache), to warm-start reruns.
+ *       A file is keyed by the numbers of inputs and latches, the direction and a hash
+ *       of the reencoded AIG and the property. The file of the same design is an exact
+ *       match, otherwise the last file with the same inputs and latches is a near match.
+ *       Nothing read from the cache is trusted, see Checker::load_cache.
+ */
+
+#ifndef FRAME_CACHE_H
+#define	FRAME_CACHE_H
+
+#include "data_structure.h"
+#include "model.h"
+#include <string>
+#include <vector>
+
+namespace car
+{
+	enum CacheMatch {CACHE_NONE, CACHE_NEAR, CACHE_EXACT};
+
+	class FrameCache
+	{
+	public:
+		FrameCache (const std::string& dir, const unsigned long long design, Model* model, const int bad, const bool forward);
+
+		//hash of the AIG, which must be reencoded, without its symbols and comments
+		static unsigned long long hash (aiger* aig);
+
+		//frames and dead cubes of the matching file, safe tells whether it was a safe run
+		CacheMatch load (std::vector<Frame>& frames, std::vector<Cube>& deads, bool& safe);
+		bool save (const std::vector<Frame>& frames, const std::vector<Cube>& deads, const bool safe);
+
+		inline const std::string& file () const {return file_;}
+
+	private:
+		std::string dir_;
+		std::string prefix_;  //name of the files of the designs with the same inputs, latches and direction
+		std::string file_;    //the file of this design
+		Model* model_;
+
+		bool read (const std::string& path, std::vector<Frame>& frames, std::vector<Cube>& deads, bool& safe);
+		std::string near_file () const;
+	};
+}
+
+#endif
@@ -94,7 +94,7 @@ void MultiSolvers::informEnd(lbool res) {
 
 MultiSolvers::MultiSolvers(ParallelSolver *s) :
         use_simplification(true), ok(true), maxnbthreads(4), nbthreads(opt_nbsolversmultithreads), nbsolvers(opt_nbsolversmultithreads), nbcompanions(4), nbcompbysolver(2),
-        allClonesAreBuilt(0), showModel(false), winner(-1), var_decay(1 / 0.95), clause_decay(1 / 0.999), cla_inc(1), var_inc(1), random_var_freq(0.02), restart_first(100),
+        allClonesAreBuilt(0), showModel(false), winner(-1), quiet(false), var_decay(1 / 0.95), clause_decay(1 / 0.999), cla_inc(1), var_inc(1), random_var_freq(0.02), restart_first(100),
         restart_inc(1.5), learntsize_factor((double) 1 / (double) 3), learntsize_inc(1.1), expensive_ccmin(true), polarity_mode(polarity_false), maxmemory(opt_maxmemory),
         maxnbsolvers(opt_maxnbsolvers), verb(0), verbEveryConflicts(10000), numvar(0), numclauses(0) {
     result = l_Undef;
@@ -609,7 +609,7 @@ lbool MultiSolvers::solve() {
     sharedcomp->setNbThreads(nbsolvers);
     if(verb >= 1)
         printf("c |  Generating clones                                                                                    |\n");
-    generateAllSolvers();
+    generateAllSolvers(); // the clones copy quiet from solvers[0]
     if(verb >= 1) {
         printf("c |  all clones generated. Memory = %6.2fMb.                                                             |\n", memUsed());
         printf("c ========================================================================================================|\n");
@@ -644,13 +644,15 @@ lbool MultiSolvers::solve() {
         timeout.tv_nsec = 0;
         if(pthread_cond_timedwait(&cfinished, &mfinished, &timeout) != ETIMEDOUT)
             done = true;
-        else
+        else if(!quiet)
             printStats();
 
         float mem = memUsed();
         if(verb >= 1) printf("c Total Memory so far : %.2fMb\n", mem);
-        if((maxmemory > 0) && (mem > maxmemory) && !sharedcomp->panicMode)
-            printf("c ** reduceDB switching to Panic Mode due to memory limitations !\n"), sharedcomp->panicMode = true;
+        if((maxmemory > 0) && (mem > maxmemory) && !sharedcomp->panicMode) {
+            if(!quiet) printf("c ** reduceDB switching to Panic Mode due to memory limitations !\n");
+            sharedcomp->panicMode = true;
+        }
 
         if(!done && !adjustedlimitonce) {
             uint64_t sumconf = 0;
@@ -665,7 +667,7 @@ lbool MultiSolvers::solve() {
                     solvers[i]->goodlimitsize -= 4;
                 }
                 adjustedlimitonce = true;
-                printf("c adjusting (once) the limits to send fewer clauses.\n");
+                if(!quiet) printf("c adjusting (once) the limits to send fewer clauses.\n");
             }
         }
     }
@@ -68,6 +68,7 @@ public:
   void setVerbosity(int i);
   int verbosity();
   void setVerbEveryConflicts(int i);
+  void setQuiet(bool b); // no messages at all on stdout, whatever the verbosity (periodic stats of solve included)
   void setShowModel(int i) {showModel = i;}
   int getShowModel() {return showModel;}
   // Problem specification:
@@ -130,6 +131,7 @@ struct Stats {
         bool showModel; // show model on/off
 
 	int winner;
+	bool quiet;
 
     vec<Lit>            add_tmp;
  	
@@ -174,6 +176,7 @@ inline bool     MultiSolvers::addClause       (const vec<Lit>& ps)    { ps.copyT
 
 inline void MultiSolvers::setVerbosity(int i) {verb = i;}
 inline void MultiSolvers::setVerbEveryConflicts(int i) {verbEveryConflicts=i;}
+inline void MultiSolvers::setQuiet(bool b) {quiet = b; for(int i = 0; i < solvers.size(); i++) solvers[i]->quiet = b;}
 inline int      MultiSolvers::nVars         ()      const   { return numvar; }
 inline int      MultiSolvers::nClauses      ()      const   { return numclauses; }
 inline int MultiSolvers::verbosity()  {return verb;}
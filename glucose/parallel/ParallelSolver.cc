@@ -84,14 +84,17 @@ ParallelSolver::ParallelSolver(int threadId) :
 {
     useUnaryWatched = true; // We want to use promoted clauses here !
     stats.growTo(parallelStatsSize,0);
+    quiet = false;
 }
 
 
 
 
 ParallelSolver::~ParallelSolver() {
-    printf("c Solver of thread %d ended.\n", thn);
-    fflush(stdout);
+    if(!quiet) {
+        printf("c Solver of thread %d ended.\n", thn);
+        fflush(stdout);
+    }
 }
 
 ParallelSolver::ParallelSolver(const ParallelSolver &s) : 
@@ -112,6 +115,7 @@ ParallelSolver::ParallelSolver(const ParallelSolver &s) :
 {
     s.goodImportsFromThreads.memCopyTo(goodImportsFromThreads);   
     useUnaryWatched = s.useUnaryWatched;
+    quiet = s.quiet;
     s.stats.copyTo(stats);
     s.elimclauses.copyTo(elimclauses); // This should be done more efficiently some day
 }
@@ -486,7 +490,7 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
     if (status != l_Undef)
         firstToFinish = sharedcomp->IFinished(this);
     if (firstToFinish) {
-        printf("c Thread %d is 100%% pure glucose! First thread to finish! (%s answer).\n", threadNumber(), status == l_True ? "SAT" : status == l_False ? "UNSAT" : "UNKOWN");
+        if (!quiet) printf("c Thread %d is 100%% pure glucose! First thread to finish! (%s answer).\n", threadNumber(), status == l_True ? "SAT" : status == l_False ? "UNSAT" : "UNKOWN");
         sharedcomp->jobStatus = status;
     }
     
@@ -115,6 +115,7 @@ public:
     bool purgatory; // mode of operation
     bool shareAfterProbation; // Share any none glue clause only after probation (seen 2 times in conflict analysis)
     bool plingeling; // plingeling strategy for sharing clauses (experimental)
+    bool quiet; // no messages at all, whatever the verbosity (set by MultiSolvers::quiet)
     int nbTimesSeenBeforeExport;
     // Stats front end
 //    uint64_t   getNbExported() { return nbexported;}
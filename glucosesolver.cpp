@@ -0,0 +1,224 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   glucosesolver.cpp
+ * Note: Glucose backend of the SAT interface, running in incremental mode
+ *       (this file and the Glucose sources must be compiled with -DINCREMENTAL)
+ */
+
+#include "satsolver.h"
+#include "resource.h"
+#include "glucose/core/Solver.h"
+#include <iostream>
+#include <stdlib.h>
+#include <new>
+using namespace std;
+using namespace Glucose;
+
+namespace car
+{
+	//the OutOfMemoryException of Glucose is turned into std::bad_alloc, which Checker handles for every backend
+	//(after releasing the memory reserve, see Resources::release_reserve)
+	class GlucoseSolver : public SATSolver, public Glucose::Solver
+	{
+	public:
+		//No variable is declared as selector (initNbInitialVars is not called): the flags used
+		//by CAR do not always appear negatively in clauses as Glucose expects from selectors,
+		//so incremental mode here only keeps the assumption levels on restarts.
+		GlucoseSolver () {setIncrementalMode ();}
+		GlucoseSolver (const GlucoseSolver& s, const bool learnts) : Glucose::Solver (s)
+		{
+			ok = s.ok;
+			if (!learnts)
+			{
+				for (int i = 0; i < Glucose::Solver::learnts.size (); i ++)
+					removeClause (Glucose::Solver::learnts[i]);
+				Glucose::Solver::learnts.clear ();
+				permanentLearnts.clear ();
+				checkGarbage ();
+			}
+		}
+		~GlucoseSolver () {}
+
+		SATSolver* clone (const bool learnts) const
+		{
+			try
+			{
+				return new GlucoseSolver (*this, learnts);
+			}
+			catch (OutOfMemoryException&)
+			{
+				Resources::release_reserve ();
+				throw std::bad_alloc ();
+			}
+		}
+		SATBackend backend () const {return BACKEND_GLUCOSE;}
+
+		bool add_clause (const std::vector<int>& cl)
+		{
+			try
+			{
+				vec<Lit> lits;
+				for (int i = 0; i < cl.size (); i ++)
+					lits.push (SAT_lit (cl[i]));
+				return addClause (lits);
+			}
+			catch (OutOfMemoryException&)
+			{
+				Resources::release_reserve ();
+				throw std::bad_alloc ();
+			}
+		}
+
+		SATResult solve (const std::vector<int>& assumption)
+		{
+			lbool ret;
+			try
+			{
+				vec<Lit> assumps;
+				for (int i = 0; i < assumption.size (); i ++)
+					assumps.push (SAT_lit (assumption[i]));
+				ret = solveLimited (assumps);
+			}
+			catch (OutOfMemoryException&)
+			{
+				Resources::release_reserve ();
+				throw std::bad_alloc ();
+			}
+			if (ret == l_True)
+				return SAT_TRUE;
+			else if (ret == l_False)
+				return SAT_FALSE;
+			return SAT_UNKNOWN;
+		}
+
+		std::vector<int> get_model ()
+		{
+			std::vector<int> res;
+			res.resize (nVars (), 0);
+			for (int i = 0; i < nVars (); i ++)
+			{
+				if (model[i] == l_True)
+					res[i] = i+1;
+				else if (model[i] == l_False)
+					res[i] = -(i+1);
+			}
+			return res;
+		}
+
+		std::vector<int> get_conflict ()
+		{
+			std::vector<int> res;
+			for (int k = 0; k < conflict.size (); k ++)
+				res.push_back (-lit_id (conflict[k]));
+			return res;
+		}
+
+		int num_vars () const {return nVars ();}
+
+		void set_conflict_budget (const long long budget)
+		{
+			if (budget < 0)
+				conflict_budget = -1;
+			else
+				setConfBudget (budget);
+		}
+
+		void set_propagation_budget (const long long budget)
+		{
+			if (budget < 0)
+				propagation_budget = -1;
+			else
+				setPropBudget (budget);
+		}
+
+		void interrupt () {Solver::interrupt ();}
+
+		SATStats stats () const
+		{
+			SATStats res;
+			res.decisions = decisions;
+			res.conflicts = conflicts;
+			return res;
+		}
+
+		//polarity[v] is true when the preferred value of v is false
+		void set_phase (const std::vector<int>& lits)
+		{
+			try
+			{
+				for (int i = 0; i < lits.size (); i ++)
+					setPolarity (var (SAT_lit (lits[i])), lits[i] < 0);
+			}
+			catch (OutOfMemoryException&)
+			{
+				Resources::release_reserve ();
+				throw std::bad_alloc ();
+			}
+		}
+
+		void dump_clauses (std::vector<std::vector<int> >& res)
+		{
+			int units = trail_lim.size () > 0 ? trail_lim[0] : trail.size ();
+			for (int i = 0; i < units; i ++)
+				res.push_back (std::vector<int> (1, lit_id (trail[i])));
+			for (int i = 0; i < clauses.size (); i ++)
+			{
+				Clause& c = ca[clauses[i]];
+				std::vector<int> cl;
+				for (int j = 0; j < c.size (); j ++)
+					cl.push_back (lit_id (c[j]));
+				res.push_back (cl);
+			}
+		}
+
+		void print_clauses ()
+		{
+			cout << "clauses in SAT solver: \n";
+			for (int i = 0; i < clauses.size (); i ++)
+			{
+				Clause& c = ca[clauses[i]];
+				for (int j = 0; j < c.size (); j ++)
+					cout << lit_id (c[j]) << " ";
+				cout << "0 " << endl;
+			}
+		}
+
+	private:
+		Lit SAT_lit (int id)
+		{
+			assert (id != 0);
+			int var = abs (id)-1;
+			while (var >= nVars ()) newVar ();
+			return ((id > 0) ? mkLit (var) : ~mkLit (var));
+		}
+
+		int lit_id (Lit l)
+		{
+			if (sign (l))
+				return -(var (l) + 1);
+			else
+				return var (l) + 1;
+		}
+	};
+
+	SATSolver* new_glucose_solver ()
+	{
+		return new GlucoseSolver ();
+	}
+}
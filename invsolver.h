@@ -34,20 +34,24 @@ namespace car
 	class InvSolver : public CARSolver
 	{
 		public:
-			InvSolver (const Model* m, bool verbose = false) : id_aiger_max_ (const_cast<Model*>(m)->max_id ())
+			InvSolver (const Model* m, Logger* log = NULL, const SATBackend backend = BACKEND_MINISAT) : CARSolver (log, backend), 
+			    id_aiger_max_ (const_cast<Model*>(m)->max_id ())
 			{
 				model_ = const_cast<Model*> (m);
-			    verbose_ = verbose;
 			    int end = model_->outputs_start ();
 			    for (int i = 0; i < end ; i ++)
                     add_clause (model_->element (i));
 			}
+			InvSolver (const InvSolver& s, const bool learnts) : CARSolver (s, learnts), model_ (s.model_), 
+			    id_aiger_max_ (s.id_aiger_max_) {}
 			~InvSolver () {;}
+			
+			InvSolver* clone (const bool learnts = false) const {return new InvSolver (*this, learnts);}
 		
 			inline bool solve_with_assumption ()
 			{
-				if (verbose_)
-					std::cout << "InvSolver::";
+				if (log_ != NULL)
+					LogLine (*log_, LOG_DEBUG) << "InvSolver::solve";
 				return solve_assumption ();
 			}
 			
@@ -91,16 +95,9 @@ namespace car
 			
 			inline void release_constraint_and ()
 			{
-				#ifdef ENABLE_PICOSAT
 				int l = assumption_.back ();
 				assumption_pop ();
  				assumption_push (-l);
-				#else
-				Minisat::Lit l = assumption_.last ();
-				//Glucose::Lit l = assumption_.last ();
-				assumption_.pop ();
- 				assumption_.push (~l);
- 				#endif
 			}
 			
 			inline int new_var () {return ++id_aiger_max_;}
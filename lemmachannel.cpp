@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   lemmachannel.cpp
+ * Note: See lemmachannel.h.
+ */
+
+#include "lemmachannel.h"
+#include <sys/mman.h>
+#include <new>
+using namespace std;
+
+namespace car
+{
+	LemmaChannel::LemmaChannel (const int members, const size_t capacity, const bool shared) : members_ (members), shared_ (shared)
+	{
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+		mask_ = size - 1;
+		size_t controls = size_t (members) * (members+2);
+		bytes_ = controls * sizeof (atomic<size_t>) + size_t (members) * size * sizeof (int);
+		if (shared){
+			memory_ = mmap (NULL, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+			if (memory_ == MAP_FAILED)
+				memory_ = NULL;
+		}
+		else
+			memory_ = ::operator new (bytes_, nothrow);
+		if (memory_ == NULL){
+			control_ = NULL;
+			rings_ = NULL;
+			return;
+		}
+		control_ = static_cast<atomic<size_t>*> (memory_);
+		for (size_t i = 0; i < controls; i ++)
+			new (&control_[i]) atomic<size_t> (0);
+		rings_ = reinterpret_cast<int*> (control_ + controls);
+	}
+
+	LemmaChannel::~LemmaChannel ()
+	{
+		if (memory_ == NULL)
+			return;
+		if (shared_)
+			munmap (memory_, bytes_);
+		else
+			::operator delete (memory_);
+	}
+
+	bool LemmaChannel::push (const int member, const Cube& cu)
+	{
+		size_t t = tail (member).load (memory_order_relaxed);
+		size_t h = t;
+		for (int r = 0; r < members_; r ++){
+			if (r == member || detached (r).load (memory_order_acquire))
+				continue;
+			size_t hr = head (member, r).load (memory_order_acquire);
+			if (t - hr > t - h)
+				h = hr;
+		}
+		if (mask_ + 1 - (t - h) < cu.size () + 1)
+			return false;
+		int* ri = ring (member);
+		ri[t & mask_] = int (cu.size ());
+		for (int i = 0; i < cu.size (); i ++)
+			ri[(t + 1 + i) & mask_] = cu[i];
+		tail (member).store (t + 1 + cu.size (), memory_order_release);
+		return true;
+	}
+
+	bool LemmaChannel::pop (const int member, Cube& cu)
+	{
+		for (int m = 0; m < members_; m ++){
+			if (m == member)
+				continue;
+			size_t h = head (m, member).load (memory_order_relaxed);
+			size_t t = tail (m).load (memory_order_acquire);
+			if (h == t)
+				continue;
+			int* ri = ring (m);
+			int size = ri[h & mask_];
+			cu.resize (size);
+			for (int i = 0; i < size; i ++)
+				cu[i] = ri[(h + 1 + i) & mask_];
+			head (m, member).store (h + 1 + size, memory_order_release);
+			return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,76 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   lemmachannel.h
+ * Note: The lemmas the CAR runs of a portfolio send to each other. Each member writes its
+ *       cubes to its own ring of integers, and every other member reads them at its own pace,
+ *       without locks. A cube is its size followed by its literals. The writer only moves
+ *       the tail of its ring and each reader only its head, each publishing its side with a
+ *       release store once the integers are written (read). When the slowest reader leaves
+ *       no room the writer drops the cube, the reader only misses a hint. A member which stops
+ *       reading (finished, crashed or killed) is detached by its owner, so that it does not hold
+ *       the rings of the others full.
+ *       The control block and the rings are one block of memory, which is shared between
+ *       the processes forked after the channel is built when it is created shared.
+ */
+
+#ifndef LEMMA_CHANNEL_H
+#define	LEMMA_CHANNEL_H
+
+#include "data_structure.h"
+#include <atomic>
+#include <stddef.h>
+
+namespace car
+{
+	class LemmaChannel
+	{
+	public:
+		//capacity is rounded up to a power of 2 integers per member. A shared channel is
+		//mapped with MAP_SHARED, the atomics must be lock free to work across processes
+		LemmaChannel (const int members, const size_t capacity = 1 << 18, const bool shared = false);
+		~LemmaChannel ();
+
+		inline int members () const {return members_;}
+		inline bool valid () const {return memory_ != NULL;}
+		//writer member: false if the ring of member has no room for cu
+		bool push (const int member, const Cube& cu);
+		//reader member: the next cube written by another member, false if none
+		bool pop (const int member, Cube& cu);
+		//member reads no more, the writers do not wait for it
+		inline void detach (const int member) {if (valid ()) detached (member).store (1, std::memory_order_release);}
+
+	private:
+		int members_;
+		size_t mask_;
+		bool shared_;
+		void* memory_;
+		size_t bytes_;
+		//the tail of member m, then its heads read by each member: members_+1 per member, then
+		//the detached flag of each member
+		std::atomic<size_t>* control_;
+		int* rings_;  //mask_+1 integers per member
+
+		inline std::atomic<size_t>& tail (const int m) {return control_[m * (members_+1)];}
+		inline std::atomic<size_t>& head (const int m, const int reader) {return control_[m * (members_+1) + 1 + reader];}
+		inline std::atomic<size_t>& detached (const int m) {return control_[members_ * (members_+1) + m];}
+		inline int* ring (const int m) {return rings_ + m * (mask_+1);}
+	};
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   logger.cpp
+ * Note: See logger.h.
+ */
+
+#include "logger.h"
+#include <new>
+using namespace std;
+
+namespace car
+{
+	Logger::Logger (ostream& out, const LogLevel level, const size_t capacity) : out_ (&out), level_ (level),
+		ring_ (capacity), head_ (0), size_ (0), dropped_ (0), busy_ (false), done_ (false) {}
+
+	Logger::~Logger ()
+	{
+		if (!thread_.joinable ())
+			return;
+		{
+			lock_guard<mutex> lock (mutex_);
+			done_ = true;
+		}
+		ready_.notify_one ();
+		thread_.join ();
+	}
+
+	void Logger::write (const string& line)
+	{
+		{
+			lock_guard<mutex> lock (mutex_);
+			if (!thread_.joinable ())
+				thread_ = std::thread (&Logger::run, this);
+			if (size_ == ring_.size ())
+			{
+				head_ = (head_ + 1) % ring_.size ();
+				size_ --;
+				dropped_ ++;
+			}
+			ring_[(head_ + size_) % ring_.size ()] = line;
+			size_ ++;
+		}
+		ready_.notify_one ();
+	}
+
+	void Logger::flush ()
+	{
+		unique_lock<mutex> lock (mutex_);
+		drained_.wait (lock, [this] {return size_ == 0 && !busy_;});
+	}
+
+	void Logger::run ()
+	{
+		vector<string> lines;
+		unique_lock<mutex> lock (mutex_);
+		while (true)
+		{
+			ready_.wait (lock, [this] {return size_ > 0 || done_;});
+			if (size_ == 0)
+				break;
+			//take the lines out of the ring, and write them without holding the lock
+			lines.clear ();
+			size_t dropped = dropped_;
+			dropped_ = 0;
+			try {
+				for (; size_ > 0; size_ --)
+				{
+					lines.push_back (string ());
+					lines.back ().swap (ring_[head_]);
+					head_ = (head_ + 1) % ring_.size ();
+				}
+			}
+			catch (std::bad_alloc&) {
+				//out of memory: the lines left are dropped
+				dropped += size_;
+				head_ = (head_ + size_) % ring_.size ();
+				size_ = 0;
+			}
+			busy_ = true;
+			lock.unlock ();
+			if (dropped > 0)
+				*out_ << "(" << dropped << " log lines dropped)\n";
+			for (size_t i = 0; i < lines.size (); i ++)
+				*out_ << lines[i] << '\n';
+			out_->flush ();
+			lock.lock ();
+			busy_ = false;
+			if (size_ == 0)
+				drained_.notify_all ();
+		}
+		drained_.notify_all ();
+	}
+}
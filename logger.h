@@ -0,0 +1,97 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   logger.h
+ * Note: Leveled log of a Checker. The lines go to a bounded ring buffer, written to the
+ *       output stream by a background thread, so that the search never waits on the output.
+ *       When the ring is full the oldest lines are dropped, and their number is reported.
+ *       A disabled level costs a comparison, the line is not even formatted.
+ */
+
+#ifndef LOGGER_H
+#define	LOGGER_H
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace car
+{
+	//QUIET: nothing, INFO: warnings and the frame sizes (at most once a second, and when a
+	//budget is exhausted), FRAMES: the frames changed at each level, DEBUG: the trace of the
+	//search and of the SAT calls (-v)
+	enum LogLevel {LOG_QUIET, LOG_INFO, LOG_FRAMES, LOG_DEBUG};
+
+	class Logger
+	{
+	public:
+		Logger (std::ostream& out, const LogLevel level = LOG_INFO, const size_t capacity = 4096);
+		~Logger ();
+
+		//must be called before the first line
+		inline void set_output (std::ostream& out) {out_ = &out;}
+		inline void set_level (const LogLevel level) {level_ = level;}
+		inline LogLevel level () const {return level_;}
+		inline bool enabled (const LogLevel level) const {return level <= level_;}
+
+		//queue a line, the thread is started by the first one
+		void write (const std::string& line);
+		//wait until the queued lines are written
+		void flush ();
+
+	private:
+		std::ostream* out_;
+		LogLevel level_;
+		std::vector<std::string> ring_;
+		size_t head_, size_;  //first line and number of lines in ring_
+		size_t dropped_;  //since the last write of the thread
+		bool busy_, done_;  //the thread writes lines out of ring_, it is to stop
+		std::thread thread_;
+		std::mutex mutex_;
+		std::condition_variable ready_, drained_;
+
+		void run ();
+	};
+
+	//a line of the log, written when it goes out of scope:
+	//  LogLine (logger, LOG_INFO) << "Frame " << level;
+	class LogLine
+	{
+	public:
+		LogLine (Logger& logger, const LogLevel level) : logger_ (logger), on_ (logger.enabled (level)) {}
+		~LogLine () {if (on_) logger_.write (buf_.str ());}
+
+		template <class T>
+		inline LogLine& operator<< (const T& v) {
+			if (on_)
+				buf_ << v;
+			return *this;
+		}
+
+	private:
+		Logger& logger_;
+		bool on_;
+		std::ostringstream buf_;
+	};
+}
+
+#endif
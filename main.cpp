@@ -20,6 +20,13 @@
 #include "statistics.h"
 #include "data_structure.h"
 #include "model.h"
+#include "resource.h"
+#include "aigreader.h"
+#include "batch.h"
+#include "options.h"
+#include "daemon.h"
+#include "portfolio.h"
+#include "scheduler.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -27,39 +34,21 @@
 #include <fstream>
 #include <signal.h>
 #include <assert.h>
+#include <new>
 using namespace std;
 using namespace car;
 
-Statistics stats;
-ofstream* dot_file = NULL;
-Model * model = NULL;
-Checker *ch = NULL;
 
+//only stop the SAT calls here, Checker::check unwinds, reports UNKNOWN and the statistics are printed as usual.
+//A second SIGINT kills the run.
 void  signal_handler (int sig_num)
 {
-    if (ch != NULL) {
-        cout << "Last Frame " << endl;
-		
-		ch->print_frames_sizes ();
-	    cout << "frame_ size:" << ch->frame_size () << endl;
-	    delete ch;
-	    ch = NULL;
+	if (sig_num == SIGALRM)
+		Resources::interrupt (RESOURCE_TIME);
+	else {
+		Resources::interrupt (RESOURCE_INTERRUPT);
+		signal (SIGINT, SIG_DFL);
 	}
-	
-	if (model != NULL) {
-	    delete model;
-	    model = NULL;
-	}
-	stats.count_total_time_end ();
-	stats.print ();
-	
-	//write the dot file tail
-	if (dot_file != NULL) {
-        (*dot_file) << "\n}" << endl;
-	    dot_file->close ();
-	    delete dot_file;
-	}
-	exit (0);
 }
 
 void print_usage () 
@@ -73,54 +62,48 @@ void print_usage ()
   printf ("       -end            state numeration from end of the sequence\n");
   printf ("       -interaion      enable intersection heuristic\n");
   printf ("       -rotation       enable rotation heurisitc\n");
+  printf ("       -sat <name>     SAT backend of all solvers: minisat, glucose or picosat (Default = minisat)\n");
+  printf ("       -sat-main|-sat-start|-sat-inv|-sat-lift|-sat-dead <name>\n");
+  printf ("                       SAT backend of one solver role only\n");
+  printf ("       -parallel <n>   solve main solver queries exceeding n conflicts with parallel Glucose (Default = off)\n");
+  printf ("       -parallel-threads <n>  threads of parallel Glucose (Default = 0, chosen by Glucose)\n");
+  printf ("       -phase <mode>   seed the main solver phases from the current state (state) or the last state found at the frame (last) (Default = off)\n");
+  printf ("       -compact <ms>   after each new frame, drop the cubes implied by the other cubes of their frame, at most ms milliseconds per frame level (Default = off)\n");
+  printf ("       -evict <n>      after each new frame, move the cubes which have not blocked a state in the last n frame levels out of the frames, the invariant check still uses them (Default = off)\n");
+  printf ("       -auto           switch -dead, -muc, -partial and -propagate on and off at each frame level by their costs and gains (Default = off)\n");
+  printf ("       -spec <n>       at each frame level, first search from the states of B with n worker threads, sharing their UCs (Default = off)\n");
+  printf ("       -bad-batch <n>  forward checking: take up to n distinct start states per start solver batch (Default = off)\n");
+  printf ("       -portfolio      run forward and backward checking at the same time, exchanging their frame cubes, the first to decide wins (Default = off)\n");
+  printf ("       -schedule <ms>  run the -portfolio-config runs (or forward and backward checking) interleaved on one thread, in slices of ms times the Luby sequence (Default = off)\n");
+  printf ("       -portfolio-config <flags>  fork a run with these flags on top of the others, once per -portfolio-config, exchanging their frame cubes in shared memory, the first to decide wins (Default = off)\n");
+  printf ("       -timeout <s>    stop with UNKNOWN after s seconds (Default = off)\n");
+  printf ("       -memout <MB>    stop with UNKNOWN when memory exceeds MB megabytes (Default = off)\n");
+  printf ("       -conflict-budget <n>     stop with UNKNOWN when a SAT call exceeds n conflicts (Default = off)\n");
+  printf ("       -propagation-budget <n>  stop with UNKNOWN when a SAT call exceeds n propagations (Default = off)\n");
+  printf ("       -checkpoint <file>  log the frames to file at each frame level (Default = off)\n");
+  printf ("       -resume <file>  continue from the last frame level logged in file by -checkpoint\n");
+  printf ("       -cache <dir>    warm start from the frames of previous runs kept in dir (Default = off)\n");
+  printf ("       -batch <list>   check the aiger files listed in file list (one per line) instead of <aiger file>\n");
+  printf ("       -jobs <n>       files checked at the same time by -batch and -daemon (Default = number of CPUs)\n");
+  printf ("       -daemon <socket>  serve JSON-line check requests on a Unix socket, or stdin for -, see daemon.h\n");
   printf ("       -e              print witness (Default = off)\n");
   printf ("       -v              print verbose information (Default = off)\n");
+  printf ("       -log <level>    quiet, info (frame sizes at most once a second), frames (changed frames at each level) or debug (= -v) (Default = info)\n");
   printf ("       -h              print help information\n");
   
   printf ("NOTE: -f and -b cannot be used together!\n");
   printf ("NOTE: -begin and -end cannot be used together!\n");
+  printf ("NOTE: -daemon takes no aiger file, its options are the defaults of the requests\n");
+  printf ("NOTE: -batch applies -timeout and -memout to each file, and cannot be used with -checkpoint or -resume\n");
+  printf ("NOTE: the aiger file can be .aig or .aag, compressed as .gz (or .xz when built with liblzma)\n");
   exit (0);
 }
 
-string get_file_name (string& s)
-{
-    size_t start_pos = s.find_last_of ("/");
-    if (start_pos == string::npos)
-       start_pos = 0;
-    else
-        start_pos += 1;
-         
-    
-    string tmp_res = s.substr (start_pos);
-    
-    string res = "";
-    //remove .aig
-
-    size_t end_pos = tmp_res.find (".aig");
-    assert (end_pos != string::npos);
-    
-    for (int i = 0; i < end_pos; i ++)
-        res += tmp_res.at (i);
-        
-    return res;
-    
-}
-
 void check_aiger (int argc, char** argv)
 {
-
-   bool forward = false;
-   bool verbose = false;
-   bool evidence = false;
-   bool minimal_uc = false;
-   bool gv = false; //to print dot format for graphviz 
-   bool dead = false;
-   bool partial = false;
-   bool propagate = false;
-   bool begin = false;
-   bool end = true;
-   bool inter = true;
-   bool rotate = false;
+   CheckOptions opts;
+   string batch_list, daemon_socket;
+   int jobs = 0;
    
    string input;
    string output_dir;
@@ -128,42 +111,27 @@ void check_aiger (int argc, char** argv)
    bool output_dir_set = false;
    for (int i = 1; i < argc; i ++)
    {
-   		if (strcmp (argv[i], "-f") == 0)
-   			forward = true;
-   		else if (strcmp (argv[i], "-b") == 0)
-   			forward = false;
-   		else if (strcmp (argv[i], "-v") == 0)
-   			verbose = true;
-   		else if (strcmp (argv[i], "-e") == 0)
-   			evidence = true;
-   		else if (strcmp (argv[i], "-h") == 0)
+   		bool bad;
+   		if (strcmp (argv[i], "-h") == 0)
    			print_usage ();
-   		else if (strcmp (argv[i], "-begin") == 0) {
-   			if (end) {
+   		else if (opts.parse (argc, argv, i, bad)) {
+   			if (bad)
+   				print_usage ();
+   		}
+   		else if (strcmp (argv[i], "-batch") == 0) {
+   			if (i+1 >= argc)
+   				print_usage ();
+   			batch_list = string (argv[++i]);
+   		}
+   		else if (strcmp (argv[i], "-jobs") == 0) {
+   			if (i+1 >= argc || (jobs = atoi (argv[++i])) <= 0)
    				print_usage ();
-   				exit (0);
-   			}
-   			begin = true;
    		}
-   		else if (strcmp (argv[i], "-end") == 0) {
-   			if (begin) {
+   		else if (strcmp (argv[i], "-daemon") == 0) {
+   			if (i+1 >= argc)
    				print_usage ();
-   				exit (0);
-   			}
-   			end = true;
+   			daemon_socket = string (argv[++i]);
    		}
-   		else if (strcmp (argv[i], "-interation") == 0)
-   			inter = true;
-      else if (strcmp (argv[i], "-muc") == 0)
-   			minimal_uc = true;
-      else if (strcmp (argv[i], "-dead") == 0)
-   			dead = true;
-      else if (strcmp (argv[i], "-partial") == 0)
-   			partial = true;
-      else if (strcmp (argv[i], "-propagate") == 0)
-   			propagate = true;
-   		else if (strcmp (argv[i], "-rotation") == 0)
-   			rotate = true;
    		else if (!input_set)
    		{
    			input = string (argv[i]);
@@ -177,14 +145,54 @@ void check_aiger (int argc, char** argv)
    		else
    			print_usage ();
    }
-   if (!input_set || !output_dir_set)
+   //the daemon takes the files from its requests, the options above are the defaults of each one
+   if (!daemon_socket.empty ())
+   {
+   		if (input_set || !batch_list.empty () || opts.uses_checkpoint () || !opts.portfolio_configs.empty () || opts.schedule > 0)
+   			print_usage ();
+   		Daemon daemon (opts, jobs);
+   		std::string error;
+   		if (!daemon.run (daemon_socket, error))
+   			fprintf (stderr, "daemon error: %s\n", error.c_str ());
+   		exit (0);
+   }
+   //the only file argument of -batch is the output directory
+   if (!batch_list.empty () && input_set && !output_dir_set)
+   {
+   		output_dir = input;
+   		output_dir_set = true;
+   		input_set = false;
+   }
+   if ((!input_set && batch_list.empty ()) || (input_set && !batch_list.empty ()) || !output_dir_set)
+   		print_usage ();
+   //the files of the list, or the runs of a portfolio, would share the checkpoint
+   if ((!batch_list.empty () || opts.several_runs ()) && opts.uses_checkpoint ())
+   		print_usage ();
+   if (opts.portfolio && (!opts.portfolio_configs.empty () || opts.schedule > 0))
    		print_usage ();
 
   //std::string output_dir (argv[3]);
   if (output_dir.at (output_dir.size()-1) != '/')
     output_dir += "/";
   //std::string s (argv[2]);
-  std::string filename = get_file_name (input);
+  if (!batch_list.empty ())
+  {
+    Batch batch (output_dir, jobs, opts.timeout);
+    std::string error;
+    if (!batch.load (batch_list, error))
+    {
+      printf ("read batch list error: %s\n", error.c_str ());
+      exit (0);
+    }
+    //the workers go on with their file, the driver is done
+    input = batch.run ();
+    if (input.empty ())
+    {
+      batch.print_summary ();
+      exit (0);
+    }
+  }
+  std::string filename = aiger_file_name (input);
   
   std::string stdout_filename = output_dir + filename + ".log";
   std::string stderr_filename = output_dir + filename + ".err";
@@ -192,14 +200,20 @@ void check_aiger (int argc, char** argv)
   
   std::string dot_file_name = output_dir + filename + ".gv";
   
-  if (!verbose)
+  if (!opts.verbose)
     freopen (stdout_filename.c_str (), "w", stdout);
   //freopen (stderr_filename.c_str (), "w", stderr);
   ofstream res_file;
   res_file.open (res_file_name.c_str ());
   
+  Statistics stats;
+  ofstream* dot_file = NULL;
+  Model * model = NULL;
+  Checker *ch = NULL;
+  Portfolio *portfolio = NULL;
+  
   //write the Bad states to dot file
-  if (gv)
+  if (opts.gv)
   {
     dot_file = new ofstream ();
     dot_file->open (dot_file_name.c_str ());
@@ -208,12 +222,15 @@ void check_aiger (int argc, char** argv)
   }
   
   stats.count_total_time_start ();
+  Resources::set_time_limit (opts.timeout);
+  if (opts.memout > 0 && !Resources::set_memory_limit (opts.memout))
+    printf ("cannot set the memory limit!\n");
+  Resources::set_sat_budgets (opts.conflict_budget, opts.propagation_budget);
   //get aiger object
    aiger* aig = aiger_init ();
    //aiger_open_and_read_from_file(aig, s.c_str());
-   aiger_open_and_read_from_file(aig, input.c_str());
-   const char * err = aiger_error(aig);
-   if (err) 
+   std::string read_error;
+   if (!read_aiger (aig, input.c_str (), read_error)) 
    {
      printf ("read agier file error!\n");
      //throw InputError(err);
@@ -223,23 +240,72 @@ void check_aiger (int argc, char** argv)
      aiger_reencode(aig);
      
    stats.count_model_construct_time_start ();
-   model = new Model (aig);
+   try {
+      model = new Model (aig);
+   }
+   catch (std::bad_alloc& e) {
+      //-memout is too small even for the model
+      res_file << "2" << endl << "b0" << endl << "." << endl;
+      res_file.close ();
+      printf ("return UNKNOWN: memory limit\n");
+      stats.count_total_time_end ();
+      stats.print ();
+      exit (0);
+   }
    stats.count_model_construct_time_end ();
    
-   if (verbose)
+   if (opts.verbose)
     model->print ();
    
-   State::set_num_inputs_and_latches (model->num_inputs (), model->num_latches ());
-   
    //assume that there is only one output needs to be checked in each aiger model, 
    //which is consistent with the HWMCC format
    assert (model->num_outputs () >= 1);
    
-   ch = new Checker (model, stats, dot_file, forward, evidence, partial, propagate, begin, end, inter, rotate, verbose, minimal_uc,dead);
-
-   aiger_reset(aig);
-   
-   bool res = ch->check (res_file);
+   bool res;
+   if (opts.schedule > 0)
+   {
+      Scheduler scheduler (model, opts);
+      std::string error;
+      if (!scheduler.load (error))
+      {
+         printf ("portfolio config error: %s\n", error.c_str ());
+         exit (0);
+      }
+      if (!opts.cache_dir.empty ())
+         scheduler.set_cache (opts.cache_dir, FrameCache::hash (aig));
+      aiger_reset(aig);
+      res = scheduler.check (res_file);
+   }
+   else if (!opts.portfolio_configs.empty ())
+   {
+      ProcessPortfolio processes (model, opts);
+      std::string error;
+      if (!processes.load (error))
+      {
+         printf ("portfolio config error: %s\n", error.c_str ());
+         exit (0);
+      }
+      if (!opts.cache_dir.empty ())
+         processes.set_cache (opts.cache_dir, FrameCache::hash (aig));
+      aiger_reset(aig);
+      res = processes.check (res_file);
+   }
+   else if (opts.portfolio)
+   {
+      portfolio = new Portfolio (model, opts, stats, dot_file);
+      if (!opts.cache_dir.empty ())
+         portfolio->set_cache (opts.cache_dir, FrameCache::hash (aig));
+      aiger_reset(aig);
+      res = portfolio->check (res_file);
+   }
+   else
+   {
+      ch = opts.new_checker (model, stats, dot_file);
+      if (!opts.cache_dir.empty ())
+         ch->set_cache (opts.cache_dir, FrameCache::hash (aig));
+      aiger_reset(aig);
+      res = ch->check (res_file);
+   }
     
    delete model;
    model = NULL;
@@ -257,6 +323,8 @@ void check_aiger (int argc, char** argv)
    stats.print ();
    delete ch;
    ch = NULL;
+   delete portfolio;
+   portfolio = NULL;
    return;
 }
 
@@ -264,6 +332,7 @@ void check_aiger (int argc, char** argv)
 int main (int argc, char ** argv)
 {
   signal (SIGINT, signal_handler);
+  signal (SIGALRM, signal_handler);
   
   check_aiger (argc, argv);
   
@@ -33,9 +33,8 @@ namespace car
 	//int MainSolver::max_flag_ = -1;
 	//vector<int> MainSolver::frame_flags_;
 	
-	MainSolver::MainSolver (Model* m, Statistics* stats, const bool verbose) 
+	MainSolver::MainSolver (Model* m, Statistics* stats, Logger* log, const SATBackend backend) : CARSolver (log, backend)
 	{
-	    verbose_ = verbose;
 	    stats_ = stats;
 		model_ = m;
 		init_flag_ = m->max_id() + 1;
@@ -105,12 +104,9 @@ namespace car
 	{
 		Cube conflict = get_uc (minimal);
 		
+		//the sizes of the minimal UCs are counted by get_uc
 		if (minimal)
-		{
-			stats_->count_orig_uc_size (int (conflict.size ()));
 			try_reduce (conflict);
-			stats_->count_reduce_uc_size (int (conflict.size ()));
-		}
 		
 			
 		if (forward)
@@ -132,6 +128,13 @@ namespace car
 		}
 	}
 	
+	void MainSolver::reset_frame (const Frame& frame, const int frame_level, const bool forward)
+	{
+		add_clause (-flag_of (frame_level));
+		frame_flags_[frame_level] = max_flag_++;
+		add_new_frame (frame, frame_level, forward);
+	}
+	
 	void MainSolver::add_clause_from_cube (const Cube& cu, const int frame_level, const bool forward)
 	{
 		int flag = flag_of (frame_level);
@@ -37,9 +37,13 @@ namespace car{
 class MainSolver : public CARSolver 
 {
 	public:
-		MainSolver (Model*, Statistics* stats, const bool verbose = false);
+		MainSolver (Model*, Statistics* stats, Logger* log = NULL, const SATBackend backend = BACKEND_MINISAT);
+		MainSolver (const MainSolver& s, const bool learnts) : CARSolver (s, learnts), max_flag_ (s.max_flag_), 
+		    frame_flags_ (s.frame_flags_), init_flag_ (s.init_flag_), dead_flag_ (s.dead_flag_), model_ (s.model_) {}
 		~MainSolver (){}
 		
+		MainSolver* clone (const bool learnts = false) const {return new MainSolver (*this, learnts);}
+		
 		//public funcitons
 		void set_assumption (const Assignment&, const int frame_level, const bool forward);
 		void set_assumption (const Assignment&, const int);
@@ -53,23 +57,23 @@ class MainSolver : public CARSolver
 		inline bool solve_with_assumption (const Assignment& st, const int p)
 		{
 		    set_assumption (st, p);
-		    if (verbose_)
-		    	std::cout << "MainSolver::";
+		    if (log_ != NULL)
+		    	LogLine (*log_, LOG_DEBUG) << "MainSolver::solve";
 		    return solve_assumption ();
 		}
 		
 		inline bool solve_with_assumption (const Assignment& st)
 		{
 		    set_assumption (st);
-		    if (verbose_)
-		    	std::cout << "MainSolver::";
+		    if (log_ != NULL)
+		    	LogLine (*log_, LOG_DEBUG) << "MainSolver::solve";
 		    return solve_assumption ();
 		}
 		
 		inline bool solve_with_assumption ()
 		{
-			if (verbose_)
-		    	std::cout << "MainSolver::";
+			if (log_ != NULL)
+		    	LogLine (*log_, LOG_DEBUG) << "MainSolver::solve";
 		    return solve_assumption ();
 		}
 		
@@ -91,6 +95,8 @@ class MainSolver : public CARSolver
 		}
 		
 		inline void clear_frame_flags () {frame_flags_.clear ();}
+		//disable the clauses of the frame at frame_level, and add those of frame under a new flag
+		void reset_frame (const Frame& frame, const int frame_level, const bool forward);
 		
 		inline int new_flag (){
 			return max_flag_++;
@@ -108,8 +114,6 @@ class MainSolver : public CARSolver
 		
 		Model* model_;
 		
-		Statistics* stats_;
-		
 		//bool verbose_;
 		
 		//functions
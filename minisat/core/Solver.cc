@@ -63,6 +63,7 @@ Solver::Solver() :
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
   , garbage_frac     (opt_garbage_frac)
+  , trail_saving     (false)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
 
@@ -79,6 +80,7 @@ Solver::Solver() :
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , reused_levels(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -131,8 +133,10 @@ Var Solver::newVar(bool sign, bool dvar)
 
 bool Solver::addClause_(vec<Lit>& ps)
 {
-    assert(decisionLevel() == 0);
     if (!ok) return false;
+    if (decisionLevel() > 0 && addClauseAboveRoot(ps))
+        return true;
+    cancelUntil(0);
 
     // Check if clause is satisfied and remove false/duplicate literals:
     sort(ps);
@@ -222,6 +226,44 @@ void Solver::cancelUntil(int level) {
     } }
 
 
+// With trail saving the solver may still be on the assumption levels of the previous call. The
+// clause is attached there if two of its literals are not false (it can then neither be unit nor
+// conflicting under any prefix of the trail), backtracking as far as needed. Returns false when
+// the clause has to be added at level 0 instead.
+bool Solver::addClauseAboveRoot(vec<Lit>& ps)
+{
+    // Only level 0 assignments may satisfy or shrink the clause:
+    sort(ps);
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < ps.size(); i++){
+        bool root = value(ps[i]) != l_Undef && level(var(ps[i])) == 0;
+        if ((root && value(ps[i]) == l_True) || ps[i] == ~p)
+            return true;
+        else if (!(root && value(ps[i]) == l_False) && ps[i] != p)
+            ps[j++] = p = ps[i];
+    }
+    ps.shrink(i - j);
+    if (ps.size() < 2) return false;
+
+    for (;;){
+        int nfree = 0, max_lvl = 0;
+        for (i = 0; i < ps.size(); i++)
+            if (value(ps[i]) != l_False){
+                Lit tmp = ps[nfree]; ps[nfree++] = ps[i]; ps[i] = tmp; }
+            else if (level(var(ps[i])) > max_lvl)
+                max_lvl = level(var(ps[i]));
+        if (nfree >= 2) break;
+        cancelUntil(max_lvl - 1);
+        if (decisionLevel() == 0) return false;
+    }
+
+    CRef cr = ca.alloc(ps, false);
+    clauses.push(cr);
+    attachClause(cr);
+    return true;
+}
+
+
 //=================================================================================================
 // Major methods:
 
@@ -760,6 +802,17 @@ lbool Solver::solve_()
 
     solves++;
 
+    // Trail saving: keep the levels of the longest assumption prefix shared with the previous call.
+    if (trail_saving){
+        int lvl = 0;
+        while (lvl < decisionLevel() && lvl < assumptions.size() && lvl < saved_assumptions.size()
+               && assumptions[lvl] == saved_assumptions[lvl])
+            lvl++;
+        cancelUntil(lvl);
+        reused_levels += lvl;
+    }else
+        cancelUntil(0);
+
     max_learnts               = nClauses() * learntsize_factor;
     learntsize_adjust_confl   = learntsize_adjust_start_confl;
     learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
@@ -792,7 +845,11 @@ lbool Solver::solve_()
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
-    cancelUntil(0);
+    if (trail_saving && ok){
+        cancelUntil(decisionLevel() < assumptions.size() ? decisionLevel() : assumptions.size());
+        assumptions.copyTo(saved_assumptions);
+    }else
+        cancelUntil(0);
     return status;
 }
 
@@ -874,6 +931,78 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 }
 
 
+//=================================================================================================
+// Copying:
+
+void Solver::copyTo(Solver& copy, bool copy_learnts) const
+{
+    assert(copy.nVars() == 0);
+
+    // Parameters:
+    copy.verbosity        = verbosity;
+    copy.var_decay        = var_decay;
+    copy.clause_decay     = clause_decay;
+    copy.random_var_freq  = random_var_freq;
+    copy.random_seed      = random_seed;
+    copy.luby_restart     = luby_restart;
+    copy.ccmin_mode       = ccmin_mode;
+    copy.phase_saving     = phase_saving;
+    copy.rnd_pol          = rnd_pol;
+    copy.rnd_init_act     = rnd_init_act;
+    copy.garbage_frac     = garbage_frac;
+    copy.trail_saving     = trail_saving;
+    copy.restart_first    = restart_first;
+    copy.restart_inc      = restart_inc;
+    copy.learntsize_factor = learntsize_factor;
+    copy.learntsize_inc   = learntsize_inc;
+    copy.learntsize_adjust_start_confl = learntsize_adjust_start_confl;
+    copy.learntsize_adjust_inc         = learntsize_adjust_inc;
+
+    // Clause database (one block copy of the region allocator) and watches:
+    ca.copyTo(copy.ca);
+    clauses.copyTo(copy.clauses);
+    learnts.copyTo(copy.learnts);
+    watches.copyTo(copy.watches);
+
+    // Variable state:
+    activity   .copyTo(copy.activity);
+    assigns    .copyTo(copy.assigns);
+    polarity   .copyTo(copy.polarity);
+    decision   .copyTo(copy.decision);
+    trail      .copyTo(copy.trail);
+    copy.trail .capacity(nVars());
+    trail_lim  .copyTo(copy.trail_lim);
+    vardata    .copyTo(copy.vardata);
+    seen       .copyTo(copy.seen);
+    order_heap .copyTo(copy.order_heap);
+
+    copy.ok                 = ok;
+    copy.cla_inc            = cla_inc;
+    copy.var_inc            = var_inc;
+    copy.qhead              = qhead;
+    copy.simpDB_assigns     = simpDB_assigns;
+    copy.simpDB_props       = simpDB_props;
+    copy.progress_estimate  = progress_estimate;
+    copy.remove_satisfied   = remove_satisfied;
+    copy.max_learnts        = max_learnts;
+    copy.learntsize_adjust_confl = learntsize_adjust_confl;
+    copy.learntsize_adjust_cnt   = learntsize_adjust_cnt;
+    copy.dec_vars           = dec_vars;
+    copy.clauses_literals   = clauses_literals;
+    copy.learnts_literals   = learnts_literals;
+
+    // The copy starts from level 0 even if this solver keeps a saved trail:
+    copy.cancelUntil(0);
+
+    if (!copy_learnts){
+        for (int i = 0; i < copy.learnts.size(); i++)
+            copy.removeClause(copy.learnts[i]);
+        copy.learnts.clear();
+        copy.checkGarbage();
+    }
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -99,6 +99,10 @@ public:
     void    interrupt();          // Trigger a (potentially asynchronous) interruption of the solver.
     void    clearInterrupt();     // Clear interrupt indicator flag.
 
+    // Copying:
+    //
+    void    copyTo(Solver& copy, bool learnts = false) const; // Copy the clause database and level-0 state into a fresh solver.
+
     // Memory managment:
     //
     virtual void garbageCollect();
@@ -124,6 +128,7 @@ public:
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
+    bool      trail_saving;       // Keep the decision levels of the assumption prefix shared by consecutive solve calls.
 
     int       restart_first;      // The initial restart limit.                                                                (default 100)
     double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
@@ -137,6 +142,7 @@ public:
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t reused_levels;       // Assumption levels kept from the previous call by trail saving.
 
 protected:
 
@@ -186,6 +192,7 @@ protected:
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
+    vec<Lit>            saved_assumptions;// Assumptions of the previous call, whose levels are still on the trail (trail saving).
     Heap<VarOrderLt>    order_heap;       // A priority queue of variables ordered with respect to the variable activity.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
@@ -226,6 +233,7 @@ protected:
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
+    bool     addClauseAboveRoot(vec<Lit>& ps);                                         // Attach a clause without backtracking to level 0 (trail saving).
     void     rebuildOrderHeap ();
 
     // Maintaining Variable/Clause activity:
@@ -205,6 +205,10 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         to.extra_clause_field = extra_clause_field;
         RegionAllocator<uint32_t>::moveTo(to); }
 
+    void copyTo(ClauseAllocator& to) const {
+        to.extra_clause_field = extra_clause_field;
+        RegionAllocator<uint32_t>::copyTo(to); }
+
     template<class Lits>
     CRef alloc(const Lits& ps, bool learnt = false)
     {
@@ -282,6 +286,19 @@ class OccLists
         dirty  .clear(free);
         dirties.clear(free);
     }
+
+    void  copyTo(OccLists& copy) const {
+        copy.occs.clear();
+        copy.occs.growTo(occs.size());
+        for (int i = 0; i < occs.size(); i++){
+            const Vec& os = occs[i];
+            Vec&       cs = copy.occs[i];
+            cs.capacity(os.size());
+            for (int j = 0; j < os.size(); j++)
+                cs.push_(os[j]); }
+        dirty  .copyTo(copy.dirty);
+        dirties.copyTo(copy.dirties);
+    }
 };
 
 
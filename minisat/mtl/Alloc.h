@@ -21,6 +21,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Alloc_h
 #define Minisat_Alloc_h
 
+#include <string.h>
+
 #include "mtl/XAlloc.h"
 #include "mtl/Vec.h"
 
@@ -79,6 +81,17 @@ class RegionAllocator
         sz = cap = wasted_ = 0;
     }
 
+    void     copyTo(RegionAllocator& to) const {
+        if (to.memory != NULL) ::free(to.memory);
+        to.memory = NULL;  // 'to' must stay destroyable if xrealloc throws
+        to.sz = to.cap = to.wasted_ = 0;
+        to.memory = (T*)xrealloc(NULL, sizeof(T)*cap);
+        memcpy(to.memory, memory, sizeof(T)*sz);
+        to.sz = sz;
+        to.cap = cap;
+        to.wasted_ = wasted_;
+    }
+
 
 };
 
@@ -139,6 +139,12 @@ class Heap {
             indices[heap[i]] = -1;
         heap.clear(dealloc); 
     }
+
+    // Copy the heap contents into 'copy' (the comparator of 'copy' is kept):
+    void copyTo(Heap& copy) const {
+        heap   .copyTo(copy.heap);
+        indices.copyTo(copy.indices);
+    }
 };
 
 
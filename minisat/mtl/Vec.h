@@ -96,8 +96,14 @@ template<class T>
 void vec<T>::capacity(int min_cap) {
     if (cap >= min_cap) return;
     int add = imax((min_cap - cap + 1) & ~1, ((cap >> 1) + 2) & ~1);   // NOTE: grow by approximately 3/2
-    if (add > INT_MAX - cap || ((data = (T*)::realloc(data, (cap += add) * sizeof(T))) == NULL) && errno == ENOMEM)
+    if (add > INT_MAX - cap)
         throw OutOfMemoryException();
+    // NOTE: keep 'data' and 'cap' when realloc fails, so that the vector can still be destroyed
+    T* mem = (T*)::realloc(data, (cap + add) * sizeof(T));
+    if (mem == NULL && errno == ENOMEM)
+        throw OutOfMemoryException();
+    data = mem;
+    cap += add;
  }
 
 
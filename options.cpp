@@ -0,0 +1,221 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   options.cpp
+ * Note: Options of one check, see options.h.
+ */
+
+#include "options.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sstream>
+using namespace std;
+
+namespace car
+{
+	CheckOptions::CheckOptions () :
+	    forward (false), verbose (false), log_level (LOG_INFO), evidence (false), minimal_uc (false), gv (false), dead (false),
+	    partial (false), propagate (false), begin (false), end (true), inter (true), rotate (false),
+	    parallel_conflicts (0), parallel_threads (0), phase (PHASE_NONE), compact (0), evict (0), autotune (false), spec (0), portfolio (false), schedule (0), bad_batch (0), timeout (0), memout (0),
+	    conflict_budget (-1), propagation_budget (-1)
+	{
+		for (int i = 0; i < ROLE_NUM; i ++)
+			backends[i] = BACKEND_MINISAT;
+	}
+
+	bool CheckOptions::parse (const int argc, char** argv, int& i, bool& bad)
+	{
+		bad = false;
+		if (strcmp (argv[i], "-f") == 0)
+			forward = true;
+		else if (strcmp (argv[i], "-b") == 0)
+			forward = false;
+		else if (strcmp (argv[i], "-v") == 0)
+			verbose = true;
+		else if (strcmp (argv[i], "-log") == 0) {
+			if (i+1 >= argc)
+				bad = true;
+			else if (strcmp (argv[++i], "quiet") == 0)
+				log_level = LOG_QUIET;
+			else if (strcmp (argv[i], "info") == 0)
+				log_level = LOG_INFO;
+			else if (strcmp (argv[i], "frames") == 0)
+				log_level = LOG_FRAMES;
+			else if (strcmp (argv[i], "debug") == 0)
+				log_level = LOG_DEBUG;
+			else
+				bad = true;
+		}
+		else if (strcmp (argv[i], "-e") == 0)
+			evidence = true;
+		else if (strcmp (argv[i], "-begin") == 0) {
+			bad = end;
+			begin = true;
+		}
+		else if (strcmp (argv[i], "-end") == 0) {
+			bad = begin;
+			end = true;
+		}
+		else if (strcmp (argv[i], "-interation") == 0)
+			inter = true;
+		else if (strcmp (argv[i], "-muc") == 0)
+			minimal_uc = true;
+		else if (strcmp (argv[i], "-dead") == 0)
+			dead = true;
+		else if (strcmp (argv[i], "-partial") == 0)
+			partial = true;
+		else if (strcmp (argv[i], "-propagate") == 0)
+			propagate = true;
+		else if (strcmp (argv[i], "-rotation") == 0)
+			rotate = true;
+		else if (strcmp (argv[i], "-sat") == 0) {
+			SATBackend backend;
+			if (i+1 >= argc || !parse_sat_backend (argv[++i], backend))
+				bad = true;
+			else {
+				for (int j = 0; j < ROLE_NUM; j ++)
+					backends[j] = backend;
+			}
+		}
+		else if (strcmp (argv[i], "-parallel") == 0)
+			bad = (i+1 >= argc || (parallel_conflicts = atoll (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-parallel-threads") == 0)
+			bad = (i+1 >= argc || (parallel_threads = atoi (argv[++i])) < 0);
+		else if (strcmp (argv[i], "-phase") == 0) {
+			if (i+1 >= argc)
+				bad = true;
+			else if (strcmp (argv[++i], "state") == 0)
+				phase = PHASE_STATE;
+			else if (strcmp (argv[i], "last") == 0)
+				phase = PHASE_LAST;
+			else
+				bad = true;
+		}
+		else if (strcmp (argv[i], "-compact") == 0)
+			bad = (i+1 >= argc || (compact = atoi (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-evict") == 0)
+			bad = (i+1 >= argc || (evict = atoi (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-auto") == 0)
+			autotune = true;
+		else if (strcmp (argv[i], "-spec") == 0)
+			bad = (i+1 >= argc || (spec = atoi (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-portfolio") == 0)
+			portfolio = true;
+		else if (strcmp (argv[i], "-bad-batch") == 0)
+			bad = (i+1 >= argc || (bad_batch = atoi (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-schedule") == 0)
+			bad = (i+1 >= argc || (schedule = atoi (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-portfolio-config") == 0) {
+			if (!(bad = (i+1 >= argc)))
+				portfolio_configs.push_back (string (argv[++i]));
+		}
+		else if (strcmp (argv[i], "-timeout") == 0)
+			bad = (i+1 >= argc || (timeout = atoi (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-memout") == 0)
+			bad = (i+1 >= argc || (memout = atol (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-conflict-budget") == 0)
+			bad = (i+1 >= argc || (conflict_budget = atoll (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-propagation-budget") == 0)
+			bad = (i+1 >= argc || (propagation_budget = atoll (argv[++i])) <= 0);
+		else if (strcmp (argv[i], "-checkpoint") == 0) {
+			if (!(bad = (i+1 >= argc)))
+				checkpoint_file = string (argv[++i]);
+		}
+		else if (strcmp (argv[i], "-resume") == 0) {
+			if (!(bad = (i+1 >= argc)))
+				resume_file = string (argv[++i]);
+		}
+		else if (strcmp (argv[i], "-cache") == 0) {
+			if (!(bad = (i+1 >= argc)))
+				cache_dir = string (argv[++i]);
+		}
+		else if (strncmp (argv[i], "-sat-", 5) == 0) {
+			int role = ROLE_MAIN;
+			if (strcmp (argv[i], "-sat-main") == 0)
+				role = ROLE_MAIN;
+			else if (strcmp (argv[i], "-sat-start") == 0)
+				role = ROLE_START;
+			else if (strcmp (argv[i], "-sat-inv") == 0)
+				role = ROLE_INV;
+			else if (strcmp (argv[i], "-sat-lift") == 0)
+				role = ROLE_LIFT;
+			else if (strcmp (argv[i], "-sat-dead") == 0)
+				role = ROLE_DEAD;
+			else {
+				bad = true;
+				return true;
+			}
+			bad = (i+1 >= argc || !parse_sat_backend (argv[++i], backends[role]));
+		}
+		else
+			return false;
+		return true;
+	}
+
+	bool CheckOptions::parse_flags (const string& flags, string& error)
+	{
+		istringstream in (flags);
+		vector<string> words;
+		string word;
+		while (in >> word)
+			words.push_back (word);
+		vector<char*> argv;
+		for (int i = 0; i < words.size (); i ++)
+			argv.push_back (&words[i][0]);
+		for (int i = 0; i < argv.size (); i ++){
+			bool bad;
+			if (!parse (argv.size (), &argv[0], i, bad) || bad){
+				error = "invalid flag " + words[i];
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool CheckOptions::valid_in_config (string& error) const
+	{
+		if (several_runs ()){
+			error = "-portfolio, -portfolio-config and -schedule cannot be nested";
+			return false;
+		}
+		//the runs would all log to (or resume from) the same file
+		if (uses_checkpoint ()){
+			error = "-checkpoint and -resume cannot be shared by the runs";
+			return false;
+		}
+		return true;
+	}
+
+	Checker* CheckOptions::new_checker (Model* model, Statistics& stats, ofstream* dot) const
+	{
+		Checker* ch = new Checker (model, stats, dot, forward, evidence, partial, propagate, begin, end, inter, rotate, verbose, minimal_uc, dead);
+		for (int i = 0; i < ROLE_NUM; i ++)
+			ch->set_sat_backend (SolverRole (i), backends[i]);
+		ch->set_parallel (parallel_conflicts, parallel_threads);
+		ch->set_phase (phase);
+		ch->set_log_level (verbose ? LOG_DEBUG : log_level);
+		ch->set_compact (compact);
+		ch->set_evict (evict);
+		ch->set_auto (autotune);
+		ch->set_spec (spec);
+		ch->set_bad_batch (bad_batch);
+		ch->set_checkpoint (checkpoint_file);
+		ch->set_resume (resume_file);
+		return ch;
+	}
+}
@@ -0,0 +1,89 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   options.h
+ * Note: Options of one check, as given on the command line and to the daemon,
+ *       and the Checker built from them.
+ */
+
+#ifndef OPTIONS_H
+#define	OPTIONS_H
+
+#include "checker.h"
+#include "statistics.h"
+#include "model.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace car
+{
+	class CheckOptions
+	{
+	public:
+		CheckOptions ();
+
+		bool forward;
+		bool verbose;
+		LogLevel log_level;  //-v means LOG_DEBUG
+		bool evidence;
+		bool minimal_uc;
+		bool gv; //to print dot format for graphviz
+		bool dead;
+		bool partial;
+		bool propagate;
+		bool begin;
+		bool end;
+		bool inter;
+		bool rotate;
+		long long parallel_conflicts;
+		int parallel_threads;
+		PhaseMode phase;
+		int compact;  //ms, 0 for none
+		int evict;  //frame levels, 0 for none
+		bool autotune;  //-auto, overrides dead, minimal_uc, partial and propagate
+		int spec;  //worker threads, 0 for none
+		bool portfolio;  //run forward and backward CAR together, see portfolio.h
+		std::vector<std::string> portfolio_configs;  //the flags of each forked run, none for no fork
+		int schedule;  //ms, the Luby unit of -schedule, 0 for none
+		int bad_batch;  //start states per start solver batch, 0 for none
+		int timeout;
+		long memout;
+		long long conflict_budget;
+		long long propagation_budget;
+		std::string checkpoint_file, resume_file, cache_dir;
+		SATBackend backends[ROLE_NUM];
+
+		//parse the option argv[i] and its argument, i is moved to the last one. Return false if argv[i]
+		//is not an option of a check, set bad if its argument is missing or wrong
+		bool parse (const int argc, char** argv, int& i, bool& bad);
+		//parse the options of flags, separated by spaces, return false with error if one is wrong
+		bool parse_flags (const std::string& flags, std::string& error);
+		inline bool uses_checkpoint () const {return !checkpoint_file.empty () || !resume_file.empty ();}
+		//-portfolio, -portfolio-config or -schedule: several checks of the design
+		inline bool several_runs () const {return portfolio || !portfolio_configs.empty () || schedule > 0;}
+		//the options of one run among others (-portfolio-config, -schedule), return false with
+		//error if they would nest the runs or share a checkpoint between them
+		bool valid_in_config (std::string& error) const;
+
+		//the Checker of model with these options, dot may be NULL
+		Checker* new_checker (Model* model, Statistics& stats, std::ofstream* dot) const;
+	};
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   parallelsatsolver.cpp
+ * Note: Escalation of expensive queries to Glucose's parallel MultiSolvers.
+ *       Every query is first given to the primary solver with a conflict budget,
+ *       only the queries that exhaust it are solved again by MultiSolvers, loaded
+ *       with the clauses of the primary solver and the assumptions as units.
+ *       (compiled with the Glucose flags, see Makefile)
+ */
+
+#include "satsolver.h"
+#include "glucose/parallel/MultiSolvers.h"
+#include <stdlib.h>
+using namespace std;
+using namespace Glucose;
+
+namespace car
+{
+	//MultiSolvers does not release its solvers and threads, this subclass does
+	class CARMultiSolvers : public Glucose::MultiSolvers
+	{
+	public:
+		CARMultiSolvers (const int threads)
+		{
+			if (threads > 0)
+				nbthreads = nbsolvers = threads;
+			//the stats it prints every few seconds would go to the log, or to the host of libsimplecar
+			setQuiet (true);
+		}
+		~CARMultiSolvers ()
+		{
+			for (int i = 0; i < solvers.size (); i ++)
+				delete solvers[i];
+			for (int i = 0; i < threads.size (); i ++)
+				free (threads[i]);
+			delete sharedcomp;
+			pthread_mutex_destroy (&m);
+			pthread_mutex_destroy (&mfinished);
+			pthread_cond_destroy (&cfinished);
+		}
+		//MultiSolvers::interrupt does nothing
+		void interrupt_all ()
+		{
+			for (int i = 0; i < solvers.size (); i ++)
+				solvers[i]->interrupt ();
+		}
+	};
+
+	class ParallelSATSolver : public SATSolver
+	{
+	public:
+		ParallelSATSolver (SATSolver* primary, const long long conflicts, const int threads) :
+		    primary_ (primary), conflicts_ (conflicts), budget_ (-1), threads_ (threads), escalated_ (false),
+		    interrupted_ (false), running_ (NULL), escalations_ (0), escalated_unsat_ (0) {}
+		~ParallelSATSolver () {delete primary_;}
+
+		SATSolver* clone (const bool learnts) const {return new ParallelSATSolver (primary_->clone (learnts), conflicts_, threads_);}
+		SATBackend backend () const {return primary_->backend ();}
+
+		bool add_clause (const std::vector<int>& cl) {return primary_->add_clause (cl);}
+
+		SATResult solve (const std::vector<int>& assumption)
+		{
+			escalated_ = false;
+			//a per-call budget not larger than the escalation threshold leaves no room for MultiSolvers
+			bool escalate = budget_ < 0 || conflicts_ < budget_;
+			primary_->set_conflict_budget (escalate ? conflicts_ : budget_);
+			SATResult res = primary_->solve (assumption);
+			if (res != SAT_UNKNOWN || !escalate || interrupted_)
+				return res;
+			escalated_ = true;
+			escalations_ ++;
+			return solve_parallel (assumption);
+		}
+
+		std::vector<int> get_model () {return escalated_ ? model_ : primary_->get_model ();}
+		std::vector<int> get_conflict () {return escalated_ ? conflict_ : primary_->get_conflict ();}
+		int num_vars () const {return primary_->num_vars ();}
+		//the budget of the primary solver, MultiSolvers runs without budget (but can be interrupted)
+		void set_conflict_budget (const long long budget) {budget_ = budget;}
+		void set_propagation_budget (const long long budget) {primary_->set_propagation_budget (budget);}
+		void interrupt ()
+		{
+			interrupted_ = true;
+			primary_->interrupt ();
+			CARMultiSolvers* ms = running_;
+			if (ms != NULL)
+				ms->interrupt_all ();
+		}
+		SATStats stats () const
+		{
+			SATStats res = primary_->stats ();
+			res.escalations = escalations_;
+			res.escalated_unsat = escalated_unsat_;
+			return res;
+		}
+		void set_phase (const std::vector<int>& lits) {primary_->set_phase (lits);}
+		void dump_clauses (std::vector<std::vector<int> >& res) {primary_->dump_clauses (res);}
+		void print_clauses () {primary_->print_clauses ();}
+
+	private:
+		SATSolver* primary_;
+		long long conflicts_;  //conflicts of the primary solver before escalation
+		long long budget_;  //conflicts budget of the primary solver per query
+		int threads_;
+		bool escalated_;  //whether the last query was answered by MultiSolvers
+		volatile bool interrupted_;
+		CARMultiSolvers* volatile running_;  //the MultiSolvers of the running escalated query
+		std::vector<int> model_, conflict_;
+		long long escalations_, escalated_unsat_;
+
+		//MultiSolvers has no assumption interface, so the assumptions become units and
+		//the UC is the whole assumption set, which is still a (non-minimal) valid UC.
+		//It is built again from dump_clauses at each escalation, nothing is kept between them
+		SATResult solve_parallel (const std::vector<int>& assumption)
+		{
+			std::vector<std::vector<int> > cls;
+			primary_->dump_clauses (cls);
+			for (int i = 0; i < assumption.size (); i ++)
+				cls.push_back (std::vector<int> (1, assumption[i]));
+
+			CARMultiSolvers ms (threads_);
+			int nvars = primary_->num_vars ();
+			for (int i = 0; i < assumption.size (); i ++)
+				nvars = max (nvars, abs (assumption[i]));
+			for (int i = 0; i < nvars; i ++)
+				ms.newVar ();
+			ms.use_simplification = false;
+			ms.eliminate ();
+
+			bool ok = true;
+			vec<Lit> lits;
+			for (int i = 0; i < cls.size () && ok; i ++)
+			{
+				lits.clear ();
+				for (int j = 0; j < cls[i].size (); j ++)
+				{
+					int id = cls[i][j];
+					lits.push ((id > 0) ? mkLit (id-1) : ~mkLit (-id-1));
+				}
+				ok = ms.addClause_ (lits);
+			}
+
+			lbool ret = l_False;
+			if (ok)
+			{
+				running_ = &ms;
+				if (interrupted_)
+					ms.interrupt_all ();
+				ret = ms.solve ();
+				running_ = NULL;
+			}
+			if (ret == l_True)
+			{
+				model_.assign (primary_->num_vars (), 0);
+				for (int i = 0; i < model_.size () && i < ms.model.size (); i ++)
+				{
+					if (ms.model[i] == l_True)
+						model_[i] = i+1;
+					else if (ms.model[i] == l_False)
+						model_[i] = -(i+1);
+				}
+				return SAT_TRUE;
+			}
+			else if (ret == l_False)
+			{
+				conflict_ = assumption;
+				escalated_unsat_ ++;
+				return SAT_FALSE;
+			}
+			return SAT_UNKNOWN;
+		}
+	};
+
+	SATSolver* new_parallel_sat_solver (SATSolver* primary, const long long conflicts, const int threads)
+	{
+		return new ParallelSATSolver (primary, conflicts, threads);
+	}
+}
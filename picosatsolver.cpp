@@ -0,0 +1,197 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   picosatsolver.cpp
+ * Note: PicoSAT backend of the SAT interface
+ */
+
+#include "satsolver.h"
+#include "resource.h"
+extern "C" {
+#include "picosat/picosat.h"
+}
+#include <iostream>
+#include <stdlib.h>
+#include <assert.h>
+using namespace std;
+
+namespace car
+{
+	class PicosatSolver : public SATSolver
+	{
+	public:
+		PicosatSolver () : decisions_ (-1), interrupted_ (false)
+		{
+			picosat_ = picosat_minit (NULL, pico_malloc, pico_realloc, pico_free);
+			picosat_set_interrupt (picosat_, this, interrupted);
+		}
+		//PicoSAT cannot copy itself, so the clause log is replayed (learnt clauses are never copied)
+		PicosatSolver (const PicosatSolver& s, const bool learnts) : decisions_ (s.decisions_), interrupted_ (false)
+		{
+			picosat_ = picosat_minit (NULL, pico_malloc, pico_realloc, pico_free);
+			picosat_set_interrupt (picosat_, this, interrupted);
+			for (int i = 0; i < s.clauses_.size (); i ++)
+				add_clause (s.clauses_[i]);
+		}
+		~PicosatSolver () {picosat_reset (picosat_);}
+
+		SATSolver* clone (const bool learnts) const {return new PicosatSolver (*this, learnts);}
+		SATBackend backend () const {return BACKEND_PICOSAT;}
+
+		//stop before PicoSAT allocates more, e.g. when clone replays a large clause log
+		//after the memory reserve has been released
+		bool add_clause (const std::vector<int>& cl)
+		{
+			Resources::check ();
+			for (int i = 0; i < cl.size (); i ++)
+				picosat_add (picosat_, SAT_lit (cl[i]));
+			picosat_add (picosat_, 0);
+			clauses_.push_back (cl);
+			return true;
+		}
+
+		SATResult solve (const std::vector<int>& assumption)
+		{
+			for (int i = 0; i < assumption.size (); i ++)
+				picosat_assume (picosat_, SAT_lit (assumption[i]));
+			int res = picosat_sat (picosat_, decisions_);
+			if (res == PICOSAT_SATISFIABLE)
+				return SAT_TRUE;
+			else if (res == PICOSAT_UNSATISFIABLE)
+				return SAT_FALSE;
+			return SAT_UNKNOWN;
+		}
+
+		std::vector<int> get_model ()
+		{
+			std::vector<int> res;
+			int max_var = picosat_variables (picosat_);
+			res.resize (max_var, 0);
+			for (int i = 1; i <= max_var; i ++)
+			{
+				int val = picosat_deref (picosat_, i);
+				if (val == 1)
+					res[i-1] = i;
+				else if (val == -1)
+					res[i-1] = -i;
+			}
+			return res;
+		}
+
+		std::vector<int> get_conflict ()
+		{
+			std::vector<int> res;
+			const int *p = picosat_failed_assumptions (picosat_);
+			while (*p != 0)
+			{
+				res.push_back (*p);
+				p ++;
+			}
+			return res;
+		}
+
+		int num_vars () const {return picosat_variables (picosat_);}
+
+		//PicoSAT has no conflict limit, so the budget bounds the decisions instead
+		void set_conflict_budget (const long long budget)
+		{
+			decisions_ = budget < 0 ? -1 : int (budget);
+		}
+
+		//the propagation limit of PicoSAT is absolute, so this one only holds for the next call
+		void set_propagation_budget (const long long budget)
+		{
+			if (budget < 0)
+				picosat_set_propagation_limit (picosat_, ~0ull);
+			else
+				picosat_set_propagation_limit (picosat_, picosat_propagations (picosat_) + budget);
+		}
+
+		void interrupt () {interrupted_ = true;}
+
+		//PicoSAT does not export its number of conflicts
+		SATStats stats () const
+		{
+			SATStats res;
+			res.decisions = picosat_decisions (picosat_);
+			return res;
+		}
+
+		//phase 1 makes the literal itself (not its variable) the preferred value
+		void set_phase (const std::vector<int>& lits)
+		{
+			for (int i = 0; i < lits.size (); i ++)
+				picosat_set_default_phase_lit (picosat_, SAT_lit (lits[i]), 1);
+		}
+
+		void dump_clauses (std::vector<std::vector<int> >& res)
+		{
+			res.insert (res.end (), clauses_.begin (), clauses_.end ());
+		}
+
+		void print_clauses ()
+		{
+			cout << "clauses in SAT solver: \n";
+			for (int i = 0; i < clauses_.size (); i ++)
+			{
+				for (int j = 0; j < clauses_[i].size (); j ++)
+					cout << clauses_[i][j] << " ";
+				cout << "0 " << endl;
+			}
+		}
+
+	private:
+		PicoSAT* picosat_;
+		std::vector<std::vector<int> > clauses_;  //clause log for clone
+		int decisions_;  //decision limit of picosat_sat
+		volatile bool interrupted_;
+
+		static int interrupted (void* s) {return ((PicosatSolver*) s)->interrupted_;}
+		
+		//PicoSAT aborts when an allocation fails, the memory reserve gives it a second chance
+		//(the release also interrupts it, so that the run stops with a memory ResourceOut)
+		static void* pico_malloc (void* state, size_t size)
+		{
+			void* res = malloc (size);
+			if (res == NULL && size > 0 && Resources::release_reserve ())
+				res = malloc (size);
+			return res;
+		}
+		static void* pico_realloc (void* state, void* p, size_t old_size, size_t new_size)
+		{
+			void* res = realloc (p, new_size);
+			if (res == NULL && new_size > 0 && Resources::release_reserve ())
+				res = realloc (p, new_size);
+			return res;
+		}
+		static void pico_free (void* state, void* p, size_t size) {free (p);}
+
+		int SAT_lit (int id)
+		{
+			assert (id != 0);
+			while (abs (id) > picosat_variables (picosat_))
+				picosat_inc_max_var (picosat_);
+			return id;
+		}
+	};
+
+	SATSolver* new_picosat_solver ()
+	{
+		return new PicosatSolver ();
+	}
+}
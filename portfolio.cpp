@@ -0,0 +1,273 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   portfolio.cpp
+ * Note: See portfolio.h.
+ */
+
+#include "portfolio.h"
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iostream>
+#include <stdio.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/wait.h>
+using namespace std;
+
+namespace car
+{
+	Portfolio::Portfolio (Model* model, const CheckOptions& opts, Statistics& stats, ofstream* dot) : lemmas_ (2)
+	{
+		CheckOptions o = opts;
+		o.forward = true;
+		checkers_[0] = o.new_checker (model, stats, dot);
+		o.forward = false;
+		checkers_[1] = o.new_checker (model, backward_stats_, NULL);
+		if (lemmas_.valid ()){
+			checkers_[0]->set_lemmas (&lemmas_, 0);
+			checkers_[1]->set_lemmas (&lemmas_, 1);
+		}
+	}
+
+	Portfolio::~Portfolio ()
+	{
+		delete checkers_[0];
+		delete checkers_[1];
+	}
+
+	bool Portfolio::check (ostream& out)
+	{
+		ostringstream res[2];
+		bool unsafe[2];  //as returned by Checker::check
+		mutex m;
+		condition_variable finished;
+		int num_finished = 0, winner = -1;
+		thread runs[2];
+		for (int i = 0; i < 2; i ++)
+			runs[i] = thread ([&, i] () {
+				Resources::set_cancel (&tokens_[i]);
+				bool r = checkers_[i]->check (res[i]);
+				lemmas_.detach (i);
+				lock_guard<mutex> lock (m);
+				unsafe[i] = r;
+				//an UNKNOWN run does not stop the other
+				if (winner < 0 && res[i].str ().compare (0, 1, "2") != 0){
+					winner = i;
+					tokens_[1-i].cancel ();
+				}
+				num_finished ++;
+				finished.notify_all ();
+			});
+		{
+			//the signals only stop the SAT calls of the main thread, the runs are cancelled here
+			unique_lock<mutex> lock (m);
+			while (num_finished < 2){
+				finished.wait_for (lock, chrono::milliseconds (10));
+				if (Resources::interrupted ()){
+					tokens_[0].cancel (Resources::stopped ());
+					tokens_[1].cancel (Resources::stopped ());
+				}
+			}
+		}
+		runs[0].join ();
+		runs[1].join ();
+
+		int i = winner < 0 ? 0 : winner;
+		out << res[i].str ();
+		printf ("Portfolio decided by: %s\n", winner < 0 ? "none" : (winner == 0 ? "forward" : "backward"));
+		printf ("Backward run exported lemmas: %lld, imported lemmas: %lld\n", backward_stats_.lemmas_exported (),
+		        backward_stats_.lemmas_imported ());
+		return unsafe[i];
+	}
+
+	ProcessPortfolio::ProcessPortfolio (Model* model, const CheckOptions& opts) : model_ (model), opts_ (opts), design_hash_ (0)
+	{
+		flags_ = opts.portfolio_configs;
+		opts_.portfolio_configs.clear ();
+	}
+
+	bool ProcessPortfolio::load (string& error)
+	{
+		for (int k = 0; k < flags_.size (); k ++){
+			const string& flags = flags_[k];
+			CheckOptions c = opts_;
+			if (!c.parse_flags (flags, error)){
+				error += " in \"" + flags + "\"";
+				return false;
+			}
+			if (!c.valid_in_config (error)){
+				error += " in \"" + flags + "\"";
+				return false;
+			}
+			configs_.push_back (c);
+		}
+		return true;
+	}
+
+	bool ProcessPortfolio::check (ostream& out)
+	{
+		int n = configs_.size ();
+		LemmaChannel lemmas (n, 1 << 18, true);
+		if (!lemmas.valid ())
+			printf ("cannot map the lemma channel, the runs share no lemmas\n");
+		//the children would print what is buffered again
+		fflush (stdout);
+		cout.flush ();
+
+		vector<pid_t> pids (n, -1);
+		vector<int> fds (n, -1);
+		vector<string> res (n);
+		int open = 0;
+		for (int k = 0; k < n; k ++){
+			int p[2];
+			if (pipe (p) != 0){
+				perror ("pipe");
+				continue;
+			}
+			pid_t pid = fork ();
+			if (pid == 0){
+				close (p[0]);
+				for (int j = 0; j < k; j ++)
+					if (fds[j] >= 0)
+						close (fds[j]);
+				run (k, lemmas, p[1]);
+			}
+			close (p[1]);
+			if (pid < 0){
+				perror ("fork");
+				close (p[0]);
+				continue;
+			}
+			pids[k] = pid;
+			fds[k] = p[0];
+			open ++;
+		}
+
+		int winner = -1;
+		bool killed = false;
+		while (open > 0){
+			vector<pollfd> polled;
+			vector<int> index;
+			for (int k = 0; k < n; k ++){
+				if (fds[k] < 0)
+					continue;
+				pollfd p;
+				p.fd = fds[k];
+				p.events = POLLIN;
+				p.revents = 0;
+				polled.push_back (p);
+				index.push_back (k);
+			}
+			if (poll (&polled[0], polled.size (), 100) < 0 && errno != EINTR)
+				break;
+			//the signals stop the supervisor only, it takes the runs down
+			if (Resources::interrupted () && !killed){
+				for (int k = 0; k < n; k ++)
+					if (fds[k] >= 0)
+						kill (pids[k], SIGKILL);
+				killed = true;
+			}
+			for (int i = 0; i < polled.size (); i ++){
+				if (polled[i].revents == 0)
+					continue;
+				int k = index[i];
+				char buf[4096];
+				ssize_t got = read (fds[k], buf, sizeof (buf));
+				if (got > 0){
+					res[k].append (buf, got);
+					continue;
+				}
+				if (got < 0 && errno == EINTR)
+					continue;
+				close (fds[k]);
+				fds[k] = -1;
+				open --;
+				waitpid (pids[k], NULL, 0);
+				lemmas.detach (k);
+				if (winner < 0 && !res[k].empty () && res[k][0] != '2'){
+					winner = k;
+					for (int j = 0; j < n; j ++)
+						if (fds[j] >= 0)
+							kill (pids[j], SIGKILL);
+				}
+			}
+		}
+
+		for (int k = 0; k < n; k ++)
+			printf ("Portfolio config %d (%s): %s\n", k, flags_[k].c_str (),
+			        res[k].empty () ? "no result" : (res[k][0] == '0' ? "safe" : (res[k][0] == '1' ? "unsafe" : "unknown")));
+		int i = winner;
+		for (int k = 0; i < 0 && k < n; k ++)
+			if (!res[k].empty ())
+				i = k;
+		if (i >= 0)
+			out << res[i];
+		else
+			out << "2" << endl << "b0" << endl << "." << endl;
+		if (winner >= 0)
+			printf ("Portfolio decided by: config %d\n", winner);
+		else {
+			printf ("Portfolio decided by: none\n");
+			if (Resources::interrupted ())
+				printf ("return UNKNOWN: %s\n", ResourceOut (Resources::stopped ()).what ());
+		}
+		return winner >= 0 && res[winner][0] == '1';
+	}
+
+	void ProcessPortfolio::run (const int k, LemmaChannel& lemmas, const int fd)
+	{
+		//the limits of the configuration, the alarm of the supervisor is not inherited
+		const CheckOptions& c = configs_[k];
+		Resources::set_time_limit (c.timeout);
+		if (c.memout > 0 && !Resources::set_memory_limit (c.memout))
+			printf ("cannot set the memory limit!\n");
+		Resources::set_sat_budgets (c.conflict_budget, c.propagation_budget);
+
+		//built after the fork, so that its logger thread runs in this process
+		Statistics stats;
+		stats.count_total_time_start ();
+		Checker* ch = c.new_checker (model_, stats, NULL);
+		if (lemmas.valid ())
+			ch->set_lemmas (&lemmas, k);
+		if (!cache_dir_.empty ())
+			ch->set_cache (cache_dir_, design_hash_);
+		ostringstream res;
+		ch->check (res);
+		stats.count_total_time_end ();
+		printf ("Portfolio config %d statistics:\n", k);
+		stats.print ();
+		cout.flush ();
+		fflush (stdout);
+
+		string text = res.str ();
+		for (size_t done = 0; done < text.size (); ){
+			ssize_t n = write (fd, text.c_str () + done, text.size () - done);
+			if (n <= 0)
+				break;
+			done += n;
+		}
+		close (fd);
+		_exit (0);
+	}
+}
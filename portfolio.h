@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   portfolio.h
+ * Note: The checks of -portfolio: a forward and a backward CAR run on the same model at
+ *       the same time, each on its own thread with its own solvers and statistics. Each run
+ *       sends the cubes of its frames and its dead states to the others, which keep those they
+ *       can prove at their own frames. The first run to decide the property cancels the others.
+ *       With -portfolio-config the runs are processes forked for each configuration instead,
+ *       sharing the lemmas in shared memory: a run out of memory or crashing only loses itself.
+ */
+
+#ifndef PORTFOLIO_H
+#define	PORTFOLIO_H
+
+#include "options.h"
+#include "checker.h"
+#include "statistics.h"
+#include "lemmachannel.h"
+#include "resource.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace car
+{
+	class Portfolio
+	{
+	public:
+		//the forward run counts in stats, the options of opts but -f and -b are used by both
+		Portfolio (Model* model, const CheckOptions& opts, Statistics& stats, std::ofstream* dot);
+		~Portfolio ();
+
+		inline void set_property (const int p) {checkers_[0]->set_property (p); checkers_[1]->set_property (p);}
+		inline void set_cache (const std::string& dir, const unsigned long long design) {
+			checkers_[0]->set_cache (dir, design);
+			checkers_[1]->set_cache (dir, design);
+		}
+		//write the result of the first run to decide to out, or UNKNOWN if none does
+		bool check (std::ostream& out);
+
+	private:
+		Statistics backward_stats_;
+		Checker* checkers_[2];  //forward, backward
+		LemmaChannel lemmas_;  //members 0 and 1 as checkers_
+		CancelToken tokens_[2];
+	};
+
+	class ProcessPortfolio
+	{
+	public:
+		//the configurations are the flags of opts.portfolio_configs, on top of the options of opts
+		ProcessPortfolio (Model* model, const CheckOptions& opts);
+
+		//parse the configurations, return false with error if one is wrong
+		bool load (std::string& error);
+		inline void set_cache (const std::string& dir, const unsigned long long design) {cache_dir_ = dir; design_hash_ = design;}
+		//fork a run for each configuration, write the result of the first one to decide to out
+		//and kill the others, or UNKNOWN if none does. A signal of the process kills them all
+		bool check (std::ostream& out);
+
+	private:
+		Model* model_;
+		CheckOptions opts_;
+		std::vector<std::string> flags_;
+		std::vector<CheckOptions> configs_;  //of flags_
+		std::string cache_dir_;
+		unsigned long long design_hash_;
+
+		//the body of the child running configs_[k], writes its result to fd
+		void run (const int k, LemmaChannel& lemmas, const int fd);
+	};
+}
+
+#endif
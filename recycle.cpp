@@ -231,6 +231,7 @@
 	    model_->update_constraint (to_add);
 	    start_solver_->update_constraint (to_add);
 	    solver_->update_constraint (to_add);
+	    constraint_gen_ ++;
     }
     
     void Checker::remove_dead_states ()
@@ -0,0 +1,195 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   resource.cpp
+ * Note: Resource budgets and interruption, see resource.h
+ */
+
+#include "resource.h"
+#include <sys/resource.h>
+#include <unistd.h>
+#include <new>
+#include <stdio.h>
+
+namespace car
+{
+	volatile sig_atomic_t Resources::stopped_ = RESOURCE_NONE;
+	SATSolver* volatile Resources::running_ = NULL;
+	long long Resources::conflicts_ = -1;
+	long long Resources::propagations_ = -1;
+	char* Resources::reserve_ = NULL;
+	long long Resources::soft_memory_ = 0;
+	std::atomic<int> Resources::calls_ (0);
+	thread_local bool Resources::worker_ = false;
+	thread_local CancelToken* Resources::cancel_ = NULL;
+	thread_local void (*Resources::yield_) (void*) = NULL;
+	thread_local void* Resources::yield_arg_ = NULL;
+	
+	static const size_t MEMORY_RESERVE = 16*1024*1024;
+	static const int MEMORY_CHECK_PERIOD = 64;  //SAT calls between two memory checks
+	
+	//size of the address space from /proc (Linux only), 0 if it cannot be read
+	static long long address_space ()
+	{
+		long long pages = 0;
+		FILE* f = fopen ("/proc/self/statm", "r");
+		if (f == NULL)
+			return 0;
+		if (fscanf (f, "%lld", &pages) != 1)
+			pages = 0;
+		fclose (f);
+		return pages * sysconf (_SC_PAGESIZE);
+	}
+
+	const char* ResourceOut::what () const
+	{
+		switch (kind_)
+		{
+			case RESOURCE_TIME:
+				return "time limit";
+			case RESOURCE_MEMORY:
+				return "memory limit";
+			case RESOURCE_SAT_BUDGET:
+				return "SAT call budget";
+			case RESOURCE_INTERRUPT:
+				return "interrupted";
+			default:
+				return "unknown";
+		}
+	}
+
+	void CancelToken::cancel (const ResourceKind kind)
+	{
+		std::lock_guard<std::mutex> lock (mutex_);
+		if (!cancelled_)
+			kind_ = kind;
+		cancelled_ = true;
+		if (running_ != NULL)
+			running_->interrupt ();
+	}
+
+	void CancelToken::set_running (SATSolver* sat)
+	{
+		std::lock_guard<std::mutex> lock (mutex_);
+		running_ = sat;
+	}
+
+	void Resources::set_time_limit (const unsigned seconds)
+	{
+		alarm (seconds);
+	}
+
+	bool Resources::set_memory_limit (const long mb)
+	{
+		struct rlimit rl;
+		if (getrlimit (RLIMIT_AS, &rl) != 0)
+			return false;
+		rlim_t limit = rlim_t (mb) * 1024 * 1024;
+		if (rl.rlim_max != RLIM_INFINITY && limit > rl.rlim_max)
+			limit = rl.rlim_max;
+		rl.rlim_cur = limit;
+		if (setrlimit (RLIMIT_AS, &rl) != 0)
+			return false;
+		soft_memory_ = (long long) limit / 10 * 9;
+		//the first failed allocation frees the reserve (see release_reserve)
+		if (reserve_ == NULL)
+			reserve_ = new (std::nothrow) char[MEMORY_RESERVE];
+		std::set_new_handler (new_handler);
+		return true;
+	}
+	
+	bool Resources::release_reserve ()
+	{
+		if (reserve_ == NULL)
+			return false;
+		delete[] reserve_;
+		reserve_ = NULL;
+		interrupt (RESOURCE_MEMORY);
+		return true;
+	}
+	
+	//the failed new is retried after the release
+	void Resources::new_handler ()
+	{
+		if (!release_reserve ())
+			throw std::bad_alloc ();
+	}
+
+	void Resources::set_sat_budgets (const long long conflicts, const long long propagations)
+	{
+		conflicts_ = conflicts;
+		propagations_ = propagations;
+	}
+
+	void Resources::interrupt (const ResourceKind kind)
+	{
+		if (stopped_ == RESOURCE_NONE)
+			stopped_ = kind;
+		SATSolver* sat = running_;
+		if (sat != NULL)
+			sat->interrupt ();
+	}
+
+	void Resources::check ()
+	{
+		if (interrupted ())
+			throw ResourceOut (ResourceKind (stopped_));
+		if (cancelled ())
+			throw ResourceOut (cancel_->kind ());
+	}
+
+	SATResult Resources::solve (SATSolver* sat, const std::vector<int>& assumption)
+	{
+		if (soft_memory_ > 0 && ++ calls_ >= MEMORY_CHECK_PERIOD)
+		{
+			calls_ = 0;
+			if (address_space () > soft_memory_)
+				interrupt (RESOURCE_MEMORY);
+		}
+		if (yield_ != NULL)
+			yield_ (yield_arg_);
+		check ();
+		if (cancel_ != NULL && cancel_->budgets_)
+		{
+			sat->set_conflict_budget (cancel_->conflicts_);
+			sat->set_propagation_budget (cancel_->propagations_);
+		}
+		else
+		{
+			sat->set_conflict_budget (conflicts_);
+			sat->set_propagation_budget (propagations_);
+		}
+		if (cancel_ != NULL)
+			cancel_->set_running (sat);
+		else if (!worker_)
+			running_ = sat;
+		if (interrupted () || cancelled ())  //stopped after check (), before running_ was set
+			sat->interrupt ();
+		SATResult res = sat->solve (assumption);
+		if (cancel_ != NULL)
+			cancel_->set_running (NULL);
+		else if (!worker_)
+			running_ = NULL;
+		if (res == SAT_UNKNOWN)
+		{
+			check ();
+			throw ResourceOut (RESOURCE_SAT_BUDGET);
+		}
+		return res;
+	}
+}
@@ -0,0 +1,121 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   resource.h
+ * Note: Resource budgets of a run (total time, memory, conflicts and propagations
+ *       of each SAT call) and interruption. Every SAT call goes through Resources::solve,
+ *       which throws ResourceOut when a budget is exhausted or the run is interrupted,
+ *       so that Checker::check can unwind and report UNKNOWN.
+ */
+
+#ifndef RESOURCE_H
+#define	RESOURCE_H
+
+#include "satsolver.h"
+#include <signal.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace car
+{
+	enum ResourceKind {RESOURCE_NONE, RESOURCE_TIME, RESOURCE_MEMORY, RESOURCE_SAT_BUDGET, RESOURCE_INTERRUPT};
+
+	class ResourceOut
+	{
+	public:
+		ResourceOut (const ResourceKind kind) : kind_ (kind) {}
+		inline ResourceKind kind () const {return kind_;}
+		const char* what () const;
+	private:
+		ResourceKind kind_;
+	};
+
+	//stops the run of the threads it is set on (Resources::set_cancel), as interrupt () stops
+	//the whole process: their running SAT call returns and every later one throws kind
+	class CancelToken
+	{
+	public:
+		CancelToken () : cancelled_ (false), kind_ (RESOURCE_INTERRUPT), budgets_ (false), conflicts_ (-1), propagations_ (-1), running_ (NULL) {}
+		void cancel (const ResourceKind kind = RESOURCE_INTERRUPT);
+		inline bool cancelled () const {return cancelled_;}
+		inline ResourceKind kind () const {return kind_;}
+		//budgets of each SAT call of these threads, instead of those of Resources::set_sat_budgets
+		inline void set_sat_budgets (const long long conflicts, const long long propagations) {budgets_ = true; conflicts_ = conflicts; propagations_ = propagations;}
+	private:
+		friend class Resources;
+		std::atomic<bool> cancelled_;
+		std::atomic<ResourceKind> kind_;
+		bool budgets_;  //set before the threads start, read only then
+		long long conflicts_, propagations_;
+		std::mutex mutex_;  //of running_, so that a solver is not interrupted after its call
+		SATSolver* running_;
+		void set_running (SATSolver* sat);
+	};
+
+	class Resources
+	{
+	public:
+		//total wall-clock seconds from now on, 0 means no limit (uses SIGALRM, see main.cpp)
+		static void set_time_limit (const unsigned seconds);
+		//address space in MB, return false on failure. The run is stopped between SAT calls when
+		//90% of it is used, the allocations beyond it throw std::bad_alloc
+		static bool set_memory_limit (const long mb);
+		//budgets of each SAT call of the process (see CancelToken), a negative budget means no limit
+		static void set_sat_budgets (const long long conflicts, const long long propagations);
+
+		//async-signal-safe: stop the running SAT call and make every later one throw
+		static void interrupt (const ResourceKind kind);
+		static inline bool interrupted () {return stopped_ != RESOURCE_NONE;}
+		static inline ResourceKind stopped () {return ResourceKind (stopped_);}
+		//throw ResourceOut if the run has been stopped
+		static void check ();
+		//an allocation failed: release the reserve kept by set_memory_limit, so that the run
+		//can unwind and report, and stop it. Return false if there is no reserve left
+		static bool release_reserve ();
+
+		//solve with the per-call budgets, the call can be interrupted while running
+		static SATResult solve (SATSolver* sat, const std::vector<int>& assumption);
+		//for the threads making SAT calls besides the main one (-spec): interrupt () does not
+		//reach their running calls, the owner of their solvers interrupts them
+		static inline void set_worker_thread () {worker_ = true;}
+		//the SAT calls of this thread also stop on token (-portfolio), and are not reached by
+		//interrupt (): the owner of token cancels it when the process is interrupted
+		static inline void set_cancel (CancelToken* token) {cancel_ = token;}
+		static inline bool cancelled () {return cancel_ != NULL && cancel_->cancelled ();}
+		//the SAT calls of this thread first call hook (arg) (-schedule), which may switch to the
+		//check of another Checker, or throw ResourceOut to stop this one. NULL for none
+		static inline void set_yield (void (*hook) (void*), void* arg) {yield_ = hook; yield_arg_ = arg;}
+
+	private:
+		static volatile sig_atomic_t stopped_;  //the ResourceKind which stopped the run
+		static SATSolver* volatile running_;  //the solver inside Resources::solve, if any
+		static long long conflicts_, propagations_;
+		static char* reserve_;
+		static long long soft_memory_;  //bytes of address space, 0 means no limit
+		static std::atomic<int> calls_;
+		static thread_local bool worker_;
+		static thread_local CancelToken* cancel_;
+		static thread_local void (*yield_) (void*);
+		static thread_local void* yield_arg_;
+		
+		static void new_handler ();
+	};
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   satsolver.cpp
+ * Note: Backend factory for the SAT interface. The backends live in separate files
+ *       (minisatsolver.cpp, glucosesolver.cpp, picosatsolver.cpp) because MiniSat
+ *       and Glucose use the same include paths for their headers.
+ */
+
+#include "satsolver.h"
+#include <string.h>
+#include <assert.h>
+
+namespace car
+{
+	SATSolver* new_sat_solver (const SATBackend backend)
+	{
+		switch (backend)
+		{
+			case BACKEND_GLUCOSE:
+				return new_glucose_solver ();
+			case BACKEND_PICOSAT:
+				return new_picosat_solver ();
+			default:
+				return new_minisat_solver ();
+		}
+	}
+
+	bool parse_sat_backend (const char* name, SATBackend& backend)
+	{
+		if (strcmp (name, "minisat") == 0)
+			backend = BACKEND_MINISAT;
+		else if (strcmp (name, "glucose") == 0)
+			backend = BACKEND_GLUCOSE;
+		else if (strcmp (name, "picosat") == 0)
+			backend = BACKEND_PICOSAT;
+		else
+			return false;
+		return true;
+	}
+
+	const char* sat_backend_name (const SATBackend backend)
+	{
+		switch (backend)
+		{
+			case BACKEND_GLUCOSE:
+				return "glucose";
+			case BACKEND_PICOSAT:
+				return "picosat";
+			default:
+				return "minisat";
+		}
+	}
+}
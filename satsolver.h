@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   satsolver.h
+ * Note: Abstract SAT interface used by CARSolver, so that the backend
+ *       (MiniSat, Glucose or PicoSAT) can be chosen at runtime for each solver role.
+ *       Literals are DIMACS-style ints: variable v is v, its negation is -v.
+ */
+
+#ifndef SAT_SOLVER_H
+#define	SAT_SOLVER_H
+
+#include <vector>
+
+namespace car
+{
+	enum SATBackend {BACKEND_MINISAT, BACKEND_GLUCOSE, BACKEND_PICOSAT};
+
+	//the roles of the SAT solvers in Checker, each of them can use its own backend
+	enum SolverRole {ROLE_MAIN, ROLE_START, ROLE_INV, ROLE_LIFT, ROLE_DEAD, ROLE_NUM};
+
+	enum SATResult {SAT_FALSE, SAT_TRUE, SAT_UNKNOWN};
+
+	//cumulative search statistics of a backend
+	struct SATStats
+	{
+		SATStats () : reused_levels (0), decisions (0), conflicts (0), escalations (0), escalated_unsat (0) {}
+		long long reused_levels;  //assumption levels kept between calls by trail saving
+		long long decisions, conflicts;
+		long long escalations, escalated_unsat;  //queries handed over to MultiSolvers, and the UNSAT ones
+	};
+
+	class SATSolver
+	{
+	public:
+		virtual ~SATSolver () {}
+
+		//copy the clause database into a new solver of the same backend,
+		//learnt clauses are copied only if learnts is true (and the backend can do it)
+		virtual SATSolver* clone (const bool learnts = false) const = 0;
+		virtual SATBackend backend () const = 0;
+
+		//return false if the solver becomes trivially UNSAT
+		virtual bool add_clause (const std::vector<int>& cl) = 0;
+		virtual SATResult solve (const std::vector<int>& assumption) = 0;
+		//the i-th element is i+1, -(i+1) or 0 (unassigned), valid after SAT_TRUE
+		virtual std::vector<int> get_model () = 0;
+		//the assumptions responsible for UNSAT, valid after SAT_FALSE
+		virtual std::vector<int> get_conflict () = 0;
+		virtual int num_vars () const = 0;
+		//limit the conflicts (propagations) of the next solve calls, a negative budget means no limit
+		virtual void set_conflict_budget (const long long budget) = 0;
+		virtual void set_propagation_budget (const long long budget) = 0;
+		//make the running (or next) solve call return SAT_UNKNOWN, async-signal-safe
+		virtual void interrupt () = 0;
+		virtual SATStats stats () const {return SATStats ();}
+		//preferred value of the given variables when they are picked as decisions,
+		//it is overwritten by phase saving as soon as they are assigned
+		virtual void set_phase (const std::vector<int>& lits) {}
+
+		//the problem clauses and the level-0 units (learnt clauses are not included)
+		virtual void dump_clauses (std::vector<std::vector<int> >& res) = 0;
+		virtual void print_clauses () = 0;
+	};
+
+	SATSolver* new_sat_solver (const SATBackend backend);
+	SATSolver* new_minisat_solver ();
+	SATSolver* new_glucose_solver ();
+	SATSolver* new_picosat_solver ();
+	//wrap primary so that a query running out of conflicts budget is handed over to
+	//Glucose's parallel MultiSolvers (threads = 0 lets Glucose choose the number of threads)
+	SATSolver* new_parallel_sat_solver (SATSolver* primary, const long long conflicts, const int threads);
+
+	//"minisat", "glucose" or "picosat", return false for unknown names
+	bool parse_sat_backend (const char* name, SATBackend& backend);
+	const char* sat_backend_name (const SATBackend backend);
+}
+
+#endif
@@ -0,0 +1,212 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   scheduler.cpp
+ * Note: See scheduler.h.
+ */
+
+#include "scheduler.h"
+#include "resource.h"
+#include <iostream>
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/mman.h>
+using namespace std;
+
+namespace car
+{
+	//the try_satisfy_by calls nest as deep as the frames, the pages are only used on demand
+	static const size_t STACK_SIZE = 64 << 20;
+
+	//the x-th (from 0) element of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+	static long luby (long x)
+	{
+		long size = 1, seq = 0;
+		while (size < x + 1){
+			seq ++;
+			size = 2 * size + 1;
+		}
+		while (size - 1 != x){
+			size = (size - 1) >> 1;
+			seq --;
+			x = x % size;
+		}
+		return 1L << seq;
+	}
+
+	Scheduler::Scheduler (Model* model, const CheckOptions& opts) : model_ (model), opts_ (opts), design_hash_ (0), running_ (NULL)
+	{
+		flags_ = opts.portfolio_configs;
+		if (flags_.empty ()){
+			flags_.push_back ("-f");
+			flags_.push_back ("-b");
+		}
+		opts_.portfolio_configs.clear ();
+		opts_.schedule = 0;
+	}
+
+	Scheduler::~Scheduler ()
+	{
+		for (int i = 0; i < engines_.size (); i ++){
+			Engine* e = engines_[i];
+			delete e->checker;
+			if (e->stack != NULL)
+				munmap (e->stack, STACK_SIZE);
+			delete e;
+		}
+	}
+
+	bool Scheduler::load (string& error)
+	{
+		for (int k = 0; k < flags_.size (); k ++){
+			Engine* e = new Engine;
+			e->flags = flags_[k];
+			e->opts = opts_;
+			e->checker = NULL;
+			e->stack = NULL;
+			e->started = e->done = e->stopped = false;
+			e->seconds = 0.0;
+			engines_.push_back (e);
+			if (!e->opts.parse_flags (e->flags, error)){
+				error += " in \"" + e->flags + "\"";
+				return false;
+			}
+			if (!e->opts.valid_in_config (error)){
+				error += " in \"" + e->flags + "\"";
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Scheduler::check (ostream& out)
+	{
+		int n = engines_.size ();
+		LemmaChannel lemmas (n);
+		for (int k = 0; k < n; k ++){
+			Engine* e = engines_[k];
+			e->checker = e->opts.new_checker (model_, e->stats, NULL);
+			if (lemmas.valid ())
+				e->checker->set_lemmas (&lemmas, k);
+			if (!cache_dir_.empty ())
+				e->checker->set_cache (cache_dir_, design_hash_);
+		}
+
+		int winner = -1, left = n;
+		for (long round = 0; left > 0; round ++){
+			chrono::milliseconds slice (opts_.schedule * luby (round));
+			for (int k = 0; k < n; k ++){
+				Engine* e = engines_[k];
+				if (e->done)
+					continue;
+				if (winner >= 0){
+					e->stopped = true;
+					//nothing to unwind
+					if (!e->started){
+						e->done = true;
+						left --;
+						continue;
+					}
+				}
+				if (!e->started){
+					void* stack = mmap (NULL, STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+					if (stack == MAP_FAILED)
+						throw bad_alloc ();
+					e->stack = static_cast<char*> (stack);
+					getcontext (&e->context);
+					e->context.uc_stack.ss_sp = e->stack;
+					e->context.uc_stack.ss_size = STACK_SIZE;
+					e->context.uc_link = &main_;
+					uintptr_t p = reinterpret_cast<uintptr_t> (e);
+					makecontext (&e->context, (void (*) ()) entry, 2, int (p >> 32), int (p & 0xffffffff));
+					e->started = true;
+				}
+				chrono::steady_clock::time_point start = chrono::steady_clock::now ();
+				running_ = e;
+				slice_end_ = start + slice;
+				Resources::set_yield (&Scheduler::yield, this);
+				swapcontext (&main_, &e->context);
+				Resources::set_yield (NULL, NULL);
+				running_ = NULL;
+				e->seconds += chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+				if (e->error)
+					rethrow_exception (e->error);
+				if (!e->done)
+					continue;
+				lemmas.detach (k);
+				left --;
+				string res = e->res.str ();
+				if (winner < 0 && !e->stopped && !res.empty () && res[0] != '2')
+					winner = k;
+			}
+		}
+
+		for (int k = 0; k < n; k ++){
+			Engine* e = engines_[k];
+			string res = e->res.str ();
+			printf ("Schedule config %d (%s): %s, %.3f seconds\n", k, e->flags.c_str (),
+			        res.empty () ? "not run" : (res[0] == '0' ? "safe" : (res[0] == '1' ? "unsafe" : "unknown")), e->seconds);
+		}
+		int i = winner < 0 ? 0 : winner;
+		out << engines_[i]->res.str ();
+		if (winner >= 0)
+			printf ("Schedule decided by: config %d\n", winner);
+		else
+			printf ("Schedule decided by: none\n");
+		for (int k = 0; k < n; k ++){
+			if (!engines_[k]->started)
+				continue;
+			printf ("Schedule config %d statistics:\n", k);
+			engines_[k]->stats.print ();
+		}
+		string res = engines_[i]->res.str ();
+		return !res.empty () && res[0] == '1';
+	}
+
+	void Scheduler::entry (int high, int low)
+	{
+		uintptr_t p = (uintptr_t (unsigned (high)) << 32) | uintptr_t (unsigned (low));
+		Engine* e = reinterpret_cast<Engine*> (p);
+		try {
+			e->checker->check (e->res);
+		}
+		catch (...) {
+			e->error = current_exception ();
+		}
+		e->done = true;
+		//back to main_ through uc_link
+	}
+
+	void Scheduler::yield (void* arg)
+	{
+		static_cast<Scheduler*> (arg)->pause ();
+	}
+
+	//the next SAT call of the running engine
+	void Scheduler::pause ()
+	{
+		Engine* e = running_;
+		if (!e->stopped && chrono::steady_clock::now () < slice_end_)
+			return;
+		if (!e->stopped)
+			swapcontext (&e->context, &main_);
+		//stopped while switched out, or when resumed to unwind
+		if (e->stopped)
+			throw ResourceOut (RESOURCE_INTERRUPT);
+	}
+}
@@ -0,0 +1,93 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   scheduler.h
+ * Note: The checks of -schedule: several Checkers interleaved on one thread, for one core.
+ *       Each Checker runs on its own stack (ucontext), and before each of its SAT calls the
+ *       scheduler switches to the next one once its time slice is over. The slices of the
+ *       rounds follow the Luby sequence (1 1 2 1 1 2 4 ...) times the unit, so a long check
+ *       gets long slices while every check keeps a share of the time. The Checkers exchange
+ *       their lemmas as those of -portfolio. The first one to decide the property stops the
+ *       others, they unwind as when the run is interrupted.
+ */
+
+#ifndef SCHEDULER_H
+#define	SCHEDULER_H
+
+#include "options.h"
+#include "checker.h"
+#include "statistics.h"
+#include "lemmachannel.h"
+#include <ucontext.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <exception>
+
+namespace car
+{
+	class Scheduler
+	{
+	public:
+		//the checks are the flags of opts.portfolio_configs on top of opts, or forward and
+		//backward if there are none. A slice of round r is opts.schedule ms times luby (r)
+		Scheduler (Model* model, const CheckOptions& opts);
+		~Scheduler ();
+
+		//parse the configurations, return false with error if one is wrong
+		bool load (std::string& error);
+		inline void set_cache (const std::string& dir, const unsigned long long design) {cache_dir_ = dir; design_hash_ = design;}
+		//run the checks, write the result of the first one to decide to out, or UNKNOWN
+		bool check (std::ostream& out);
+
+	private:
+		struct Engine
+		{
+			std::string flags;
+			CheckOptions opts;
+			Statistics stats;
+			Checker* checker;
+			ucontext_t context;
+			char* stack;
+			std::ostringstream res;
+			bool started, done, stopped;
+			double seconds;  //of its slices
+			std::exception_ptr error;
+		};
+
+		Model* model_;
+		CheckOptions opts_;
+		std::vector<std::string> flags_;
+		std::vector<Engine*> engines_;
+		std::string cache_dir_;
+		unsigned long long design_hash_;
+
+		ucontext_t main_;  //of check
+		Engine* running_;
+		std::chrono::steady_clock::time_point slice_end_;
+
+		//the body of the stack of an engine, given as two ints
+		static void entry (int high, int low);
+		//the hook of Resources::set_yield
+		static void yield (void* arg);
+		void pause ();
+	};
+}
+
+#endif
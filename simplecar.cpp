@@ -0,0 +1,195 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   simplecar.cpp
+ * Note: In-process API, see simplecar.h. The check writes its .res text to a string,
+ *       which is read back into the CheckResult.
+ */
+
+#include "simplecar.h"
+#include "framecache.h"
+#include "resource.h"
+#include <sstream>
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <new>
+using namespace std;
+
+namespace car
+{
+	//cancels the token of the check after seconds, unless it is stopped before
+	class Watchdog
+	{
+	public:
+		Watchdog (CancelToken& token, const int seconds) : token_ (token), done_ (false)
+		{
+			if (seconds > 0)
+				thread_ = std::thread (&Watchdog::wait, this, seconds);
+		}
+		~Watchdog ()
+		{
+			{
+				std::lock_guard<std::mutex> lock (mutex_);
+				done_ = true;
+			}
+			cond_.notify_one ();
+			if (thread_.joinable ())
+				thread_.join ();
+		}
+
+	private:
+		CancelToken& token_;
+		std::thread thread_;
+		std::mutex mutex_;
+		std::condition_variable cond_;
+		bool done_;
+
+		void wait (const int seconds)
+		{
+			std::unique_lock<std::mutex> lock (mutex_);
+			if (!cond_.wait_for (lock, std::chrono::seconds (seconds), [this] {return done_;}))
+				token_.cancel (RESOURCE_TIME);
+		}
+	};
+
+	static CheckResult error_result (const int property, const string& reason)
+	{
+		CheckResult res;
+		res.verdict = VERDICT_ERROR;
+		res.property = property;
+		res.reason = reason;
+		return res;
+	}
+
+	static vector<bool> bits (const string& line)
+	{
+		vector<bool> res (line.size ());
+		for (int i = 0; i < line.size (); i ++)
+			res[i] = (line[i] == '1');
+		return res;
+	}
+
+	static CheckResult check (Model* model, const CheckOptions& opts, const int property, ostream* log, const unsigned long long design)
+	{
+		if (property < 0 || property >= model->num_outputs ())
+			return error_result (property, "property exceeds the outputs");
+		ostream null_log (NULL);
+		ostream& out = (log != NULL) ? *log : null_log;
+
+		//the address space limit and the new handler would stay on the host process
+		if (opts.memout > 0)
+			return error_result (property, "memout is not supported in-process");
+		//a single Checker runs the check
+		if (opts.several_runs ())
+			return error_result (property, "-portfolio, -portfolio-config and -schedule are not supported in-process");
+
+		Statistics stats;
+		ostringstream res_text;
+		Checker* ch = opts.new_checker (model, stats, NULL);
+		ch->set_log (out);
+		if (log == NULL)
+			ch->set_log_level (LOG_QUIET);
+		ch->set_property (property);
+		if (!opts.cache_dir.empty () && design != 0)
+			ch->set_cache (opts.cache_dir, design);
+		//the token stops this check only and holds its budgets, the checks of the other threads go on
+		CancelToken token;
+		token.set_sat_budgets (opts.conflict_budget, opts.propagation_budget);
+		Resources::set_cancel (&token);
+		{
+			Watchdog watchdog (token, opts.timeout);
+			ch->check (res_text);
+		}
+		Resources::set_cancel (NULL);
+		delete ch;
+
+		//verdict, property, the counterexample and "."
+		CheckResult res;
+		res.property = property;
+		ResourceKind kind = token.cancelled () ? token.kind () : Resources::stopped ();
+		istringstream in (res_text.str ());
+		string verdict, line;
+		getline (in, verdict);
+		getline (in, line);
+		if (verdict == "0")
+			res.verdict = VERDICT_SAFE;
+		else if (verdict == "1")
+			res.verdict = VERDICT_UNSAFE;
+		else
+		{
+			res.verdict = VERDICT_UNKNOWN;
+			res.reason = ResourceOut (kind == RESOURCE_NONE ? RESOURCE_SAT_BUDGET : kind).what ();
+		}
+		if (res.verdict == VERDICT_UNSAFE && opts.evidence && getline (in, line) && line != ".")
+		{
+			res.init = bits (line);
+			while (getline (in, line) && line != ".")
+				res.inputs.push_back (bits (line));
+		}
+		return res;
+	}
+
+	//binary AIGs may hold zeros, so the text is read by its size
+	struct StringReader
+	{
+		const string* text;
+		size_t pos;
+	};
+
+	static int string_get (void* state)
+	{
+		StringReader* r = (StringReader*) state;
+		return r->pos < r->text->size () ? (unsigned char) (*r->text)[r->pos++] : EOF;
+	}
+
+	CheckResult check_aiger_string (const string& text, const CheckOptions& opts, const int property, ostream* log)
+	{
+		aiger* aig = aiger_init ();
+		StringReader reader = {&text, 0};
+		const char* err = aiger_read_generic (aig, &reader, string_get);
+		if (err != NULL)
+		{
+			CheckResult res = error_result (property, err);
+			aiger_reset (aig);
+			return res;
+		}
+		if (!aiger_is_reencoded (aig))
+			aiger_reencode (aig);
+		Model* model;
+		try {
+			model = new Model (aig);
+		}
+		catch (std::bad_alloc& e) {
+			aiger_reset (aig);
+			return error_result (property, "memory limit");
+		}
+		unsigned long long design = opts.cache_dir.empty () ? 0 : FrameCache::hash (aig);
+		aiger_reset (aig);
+		CheckResult res = check (model, opts, property, log, design);
+		delete model;
+		return res;
+	}
+
+	CheckResult check_model (Model* model, const CheckOptions& opts, const int property, ostream* log)
+	{
+		return check (model, opts, property, log, 0);
+	}
+}
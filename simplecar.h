@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   simplecar.h
+ * Note: In-process API of libsimplecar.a (make libsimplecar). A check writes nothing but
+ *       its log stream, and returns its verdict and counterexample as values.
+ *       Each Checker keeps its own state, so checks of different designs may run on different
+ *       threads. The timeout and the SAT budgets of a check are held by its own token (see
+ *       CancelToken) and apply to that check only. An interrupt () of Resources stops all
+ *       the running checks.
+ */
+
+#ifndef SIMPLECAR_H
+#define	SIMPLECAR_H
+
+#include "options.h"
+#include "model.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace car
+{
+	enum Verdict {VERDICT_SAFE, VERDICT_UNSAFE, VERDICT_UNKNOWN, VERDICT_ERROR};
+
+	struct CheckResult
+	{
+		Verdict verdict;
+		int property;  //index of the output checked
+		std::string reason;  //the budget exhausted for UNKNOWN, the error for ERROR
+		//counterexample of UNSAFE with opts.evidence: the latches of the initial state
+		//and the inputs of each step
+		std::vector<bool> init;
+		std::vector<std::vector<bool> > inputs;
+	};
+
+	//check the output property of the AIGER text, ASCII or binary. The limits are opts.timeout
+	//(a watchdog thread, no signal), opts.conflict_budget and opts.propagation_budget. opts.memout
+	//would limit the host process, it gives ERROR, and so do opts.portfolio, opts.portfolio_configs
+	//and opts.schedule: the check is that of a single Checker. The messages of opts.log_level go to log,
+	//NULL drops them
+	CheckResult check_aiger_string (const std::string& text, const CheckOptions& opts, const int property = 0, std::ostream* log = NULL);
+
+	//the same on a Model, which is not changed. opts.cache_dir is ignored, it needs the AIG
+	CheckResult check_model (Model* model, const CheckOptions& opts, const int property = 0, std::ostream* log = NULL);
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   specpool.cpp
+ * Note: See specpool.h.
+ */
+
+#include "specpool.h"
+#include "resource.h"
+#include <thread>
+#include <chrono>
+using namespace std;
+
+namespace car
+{
+	SpecNode* SpecPool::new_node (const int worker)
+	{
+		deque<SpecNode>& nodes = queues_[worker].nodes;
+		nodes.push_back (SpecNode ());
+		return &nodes.back ();
+	}
+
+	void SpecPool::push (const int worker, const SpecTask& t)
+	{
+		pending_ ++;
+		lock_guard<mutex> lock (queues_[worker].mutex);
+		queues_[worker].tasks.push_back (t);
+	}
+
+	bool SpecPool::pop (const int worker, SpecTask& t)
+	{
+		while (!stop_)
+		{
+			{
+				Queue& q = queues_[worker];
+				lock_guard<mutex> lock (q.mutex);
+				if (!q.tasks.empty ())
+				{
+					t = q.tasks.back ();
+					q.tasks.pop_back ();
+					return true;
+				}
+			}
+			for (int i = 1; i < workers (); i ++)
+			{
+				Queue& q = queues_[(worker + i) % workers ()];
+				lock_guard<mutex> lock (q.mutex);
+				if (!q.tasks.empty ())
+				{
+					t = q.tasks.front ();
+					q.tasks.pop_front ();
+					return true;
+				}
+			}
+			//the running tasks may still push some
+			if (pending_ == 0)
+				return false;
+			this_thread::sleep_for (chrono::microseconds (50));
+		}
+		return false;
+	}
+
+	void SpecPool::publish (const SpecUC& u)
+	{
+		lock_guard<mutex> lock (mutex_);
+		ucs_.push_back (u);
+	}
+
+	void SpecPool::fetch (size_t& next, vector<SpecUC>& res)
+	{
+		lock_guard<mutex> lock (mutex_);
+		for (; next < ucs_.size (); next ++)
+			res.push_back (ucs_[next]);
+	}
+
+	void SpecPool::found (SpecNode* leaf)
+	{
+		{
+			lock_guard<mutex> lock (mutex_);
+			if (cex_ == NULL)
+				cex_ = leaf;
+		}
+		stop ();
+	}
+
+	void SpecPool::stop ()
+	{
+		stop_ = true;
+		for (int i = 0; i < solvers_.size (); i ++)
+			if (solvers_[i] != NULL)
+				solvers_[i]->interrupt ();
+	}
+
+	void SpecPool::run (const function<void (int)>& work)
+	{
+		vector<thread> threads;
+		for (int i = 0; i < workers (); i ++)
+		{
+			threads.push_back (thread ([this, &work, i] {
+				Resources::set_worker_thread ();
+				try {
+					work (i);
+				}
+				catch (...) {
+					{
+						lock_guard<mutex> lock (mutex_);
+						if (!error_)
+							error_ = current_exception ();
+					}
+					stop ();
+				}
+				lock_guard<mutex> lock (mutex_);
+				finished_ ++;
+				all_finished_.notify_one ();
+			}));
+		}
+		{
+			//the signals only interrupt the SAT calls of the main thread
+			unique_lock<mutex> lock (mutex_);
+			while (finished_ < workers ())
+			{
+				all_finished_.wait_for (lock, chrono::milliseconds (10));
+				if ((Resources::interrupted () || Resources::cancelled ()) && !stop_)
+				{
+					lock.unlock ();
+					stop ();
+					lock.lock ();
+				}
+			}
+		}
+		for (int i = 0; i < threads.size (); i ++)
+			threads[i].join ();
+		if (error_)
+			rethrow_exception (error_);
+	}
+}
@@ -0,0 +1,123 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   specpool.h
+ * Note: The workers of -spec and what they share. Each worker has a deque of tasks: it takes
+ *       its newest task, and when it has none it steals the oldest one of another worker. The
+ *       UCs found by the workers go to a store which every worker reads before its next query,
+ *       and the Checker at the end. The first counterexample found stops all the workers.
+ */
+
+#ifndef SPEC_POOL_H
+#define	SPEC_POOL_H
+
+#include "data_structure.h"
+#include "carsolver.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace car
+{
+	//a state found by a worker, with the path back to the state of B_ it started from
+	struct SpecNode
+	{
+		Assignment inputs, latches;
+		SpecNode* parent;  //NULL for a state of B_
+		State* state;  //in B_, NULL for a found state until it is added
+	};
+
+	struct SpecTask
+	{
+		SpecNode* node;
+		int level;  //of the frame the node is tried at
+		bool again;  //after a new state, a blocked node goes on at the next frame
+	};
+
+	//cu blocks the states of the frame at level
+	struct SpecUC
+	{
+		Cube cu;
+		int level;
+	};
+
+	class SpecPool
+	{
+	public:
+		SpecPool (const int workers) : queues_ (workers), solvers_ (workers, NULL), pending_ (0), stop_ (false),
+			finished_ (0), cex_ (NULL) {}
+
+		inline int workers () const {return int (queues_.size ());}
+		//the SAT solver of worker, interrupted by stop (), must be set before run
+		inline void set_solver (const int worker, CARSolver* solver) {solvers_[worker] = solver;}
+
+		//a node of worker, kept as long as the pool
+		SpecNode* new_node (const int worker);
+		//the nodes made by worker, once run returned
+		inline std::deque<SpecNode>& nodes (const int worker) {return queues_[worker].nodes;}
+		void push (const int worker, const SpecTask& t);
+		//the newest task of worker, or the oldest one of another worker. Return false when no
+		//task is left, queued or running, or the pool is stopped
+		bool pop (const int worker, SpecTask& t);
+		//the task taken by pop is finished, the tasks it made are pushed
+		inline void done () {pending_ --;}
+
+		void publish (const SpecUC& u);
+		//the UCs published from index next on, next is moved past them
+		void fetch (size_t& next, std::vector<SpecUC>& res);
+		//in the order they were published, once run returned
+		inline const std::vector<SpecUC>& ucs () const {return ucs_;}
+
+		//leaf ends a counterexample, the first one stops the pool
+		void found (SpecNode* leaf);
+		inline SpecNode* counterexample () const {return cex_;}
+		//stop the workers, and interrupt their running SAT calls
+		void stop ();
+		inline bool stopped () const {return stop_;}
+
+		//run work (worker) on a thread for each worker until no task is left or the pool is
+		//stopped. Resources::interrupted () or cancelled () stops the pool, and an exception of
+		//work is rethrown
+		void run (const std::function<void (int)>& work);
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<SpecTask> tasks;
+			std::deque<SpecNode> nodes;  //only grown by the worker, so the nodes never move
+		};
+		std::vector<Queue> queues_;
+		std::vector<CARSolver*> solvers_;
+		std::atomic<long> pending_;  //tasks queued or running
+		std::atomic<bool> stop_;
+
+		std::mutex mutex_;  //of the members below
+		std::vector<SpecUC> ucs_;
+		int finished_;  //workers
+		std::condition_variable all_finished_;
+		SpecNode* cex_;
+		std::exception_ptr error_;
+	};
+}
+
+#endif
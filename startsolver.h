@@ -31,9 +31,9 @@
 namespace car {
     class StartSolver : public CARSolver {
     public:
-        StartSolver (const Model* m, const int bad, const bool forward, const bool verbose = false)
+        StartSolver (const Model* m, const int bad, const bool forward, Logger* log = NULL, 
+            const SATBackend backend = BACKEND_MINISAT) : CARSolver (log, backend)
         {
-            verbose_ = verbose;
             if (!forward)
                 add_cube (const_cast<Model*>(m)->init ());
             else
@@ -46,13 +46,19 @@ namespace car {
             forward_ = forward;
             max_id_ = const_cast<Model*>(m)->max_id () + 1;
             flag_ = max_id_;
+            next_id_ = flag_;
+            batch_flag_ = 0;
         }
+        StartSolver (const StartSolver& s, const bool learnts) : CARSolver (s, learnts), max_id_ (s.max_id_), 
+            flag_ (s.flag_), next_id_ (s.next_id_), batch_flag_ (s.batch_flag_), forward_ (s.forward_) {}
         ~StartSolver () {}
         
+        StartSolver* clone (const bool learnts = false) const {return new StartSolver (*this, learnts);}
+        
         inline bool solve_with_assumption ()
         {
-        	if (verbose_)
-        		std::cout << "StartSolver::";
+        	if (log_ != NULL)
+        		LogLine (*log_, LOG_DEBUG) << "StartSolver::solve";
         	return solve_assumption ();
         }
         
@@ -66,7 +72,29 @@ namespace car {
             }
             assumption_pop ();
             assumption_push (-flag_);
-            assumption_push (++flag_);
+            flag_ = ++ next_id_;
+            assumption_push (flag_);
+        }
+        
+        //the cubes of block_in_batch are blocked until end_batch (-bad-batch)
+        inline void begin_batch ()
+        {
+            batch_flag_ = ++ next_id_;
+            assumption_push (batch_flag_);
+        }
+        inline void block_in_batch (const Cube& cu)
+        {
+            std::vector<int> cl;
+            cl.push_back (-batch_flag_);
+            for (int i = 0; i < cu.size (); i ++)
+                cl.push_back (-cu[i]);
+            add_clause (cl);
+        }
+        inline void end_batch ()
+        {
+            assumption_pop ();
+            add_clause (-batch_flag_);
+            batch_flag_ = 0;
         }
         inline void add_clause_with_flag (const Cube& cu)
         {
@@ -85,6 +113,8 @@ namespace car {
      private:
         int max_id_;
         int flag_;
+        int next_id_;  //the last flag given out
+        int batch_flag_;  //0 out of a batch
         bool forward_;
         
     };
@@ -49,6 +49,7 @@ class Statistics
             compress_reduce_uc_ratio_ = 0.0;
             orig_uc_size_ = 0;
             reduce_uc_size_ = 0;
+            time_minimal_uc_ = 0.0;
             num_clause_contain_ = 0;
         	num_state_contain_ = 0;
         	num_clause_contain_success_ = 0;
@@ -57,6 +58,24 @@ class Statistics
         	num_detect_dead_state_SAT_calls_ = 0;
         	time_detect_dead_state_SAT_calls_ = 0.0;
         	num_detect_dead_state_success_ = 0;
+        	num_reused_levels_ = 0;
+        	num_main_solver_decisions_ = 0;
+        	num_main_solver_conflicts_ = 0;
+        	num_cache_cubes_ = 0;
+        	num_cache_seeded_ = 0;
+        	num_compact_checked_ = 0;
+        	num_compact_removed_ = 0;
+        	time_compact_ = 0.0;
+        	num_evicted_ = 0;
+        	num_spec_ucs_ = 0;
+        	time_spec_ = 0.0;
+        	num_lemmas_exported_ = 0;
+        	num_lemmas_imported_ = 0;
+        	num_start_batches_ = 0;
+        	num_start_batched_ = 0;
+        	num_start_batch_stale_ = 0;
+        	num_escalations_ = 0;
+        	num_escalated_unsat_ = 0;
 
         }
         ~Statistics () {}
@@ -67,6 +86,8 @@ class Statistics
             std::cout << "      Num of main solver SAT Calls: " << num_main_solver_SAT_calls_ << std::endl;
             std::cout << "      Num of inv solver SAT Calls: " << num_inv_solver_SAT_calls_ << std::endl;
             std::cout << "      Num of start solver SAT Calls: " << num_start_solver_SAT_calls_ << std::endl;
+            std::cout << "Num of main solver decisions: " << num_main_solver_decisions_ << std::endl;
+            std::cout << "Num of main solver conflicts: " << num_main_solver_conflicts_ << std::endl;
             //std::cout << "      Num of reduce uc SAT Calls: " << num_reduce_uc_SAT_calls_ << std::endl;
             //std::cout << "      Num of detect dead state SAT Calls: " << num_detect_dead_state_SAT_calls_ << std::endl;
             std::cout << "Time of total SAT Calls: " << time_SAT_calls_ << std::endl;
@@ -81,6 +102,22 @@ class Statistics
             std::cout << "Num of clause contain success: " << num_clause_contain_success_ << std::endl;
             std::cout << "Clause contain successful rate: " << (double)num_clause_contain_success_/num_clause_contain_ << std::endl;
             std::cout << "Num of state contain: " << num_state_contain_ << std::endl;
+            std::cout << "Num of reused assumption levels: " << num_reused_levels_ << std::endl;
+            std::cout << "Num of cached cubes: " << num_cache_cubes_ << std::endl;
+            std::cout << "Num of cached cubes seeded: " << num_cache_seeded_ << std::endl;
+            std::cout << "Num of compaction checked cubes: " << num_compact_checked_ << std::endl;
+            std::cout << "Num of compaction removed cubes: " << num_compact_removed_ << std::endl;
+            std::cout << "Time of compaction: " << time_compact_ << std::endl;
+            std::cout << "Num of evicted cubes: " << num_evicted_ << std::endl;
+            std::cout << "Num of speculative UCs: " << num_spec_ucs_ << std::endl;
+            std::cout << "Time of speculation: " << time_spec_ << std::endl;
+            std::cout << "Num of exported lemmas: " << num_lemmas_exported_ << std::endl;
+            std::cout << "Num of imported lemmas: " << num_lemmas_imported_ << std::endl;
+            std::cout << "Num of start state batches: " << num_start_batches_ << std::endl;
+            std::cout << "Num of start states batched: " << num_start_batched_ << std::endl;
+            std::cout << "Num of stale batched start states: " << num_start_batch_stale_ << std::endl;
+            std::cout << "Num of escalated SAT calls: " << num_escalations_ << std::endl;
+            std::cout << "Num of escalated UNSAT calls (whole state as UC): " << num_escalated_unsat_ << std::endl;
             std::cout << "Time of state contain: " << time_state_contain_ << std::endl;
             
             //std::cout << "Sum of original uc: " << orig_uc_size_ << std::endl;
@@ -179,6 +216,14 @@ class Statistics
         {
             reduce_uc_size_ += size;
         }
+        inline void count_minimal_uc_time (double seconds)
+        {
+            time_minimal_uc_ += seconds;
+        }
+        //read by -auto
+        inline long long orig_uc_size () const {return orig_uc_size_;}
+        inline long long reduce_uc_size () const {return reduce_uc_size_;}
+        inline double minimal_uc_time () const {return time_minimal_uc_;}
         inline void count_clause_contain_time_start ()
         {
         	begin_ = clock ();
@@ -220,6 +265,62 @@ class Statistics
         {
             num_detect_dead_state_success_ += 1;
         }
+        inline void count_reused_levels (long long n)
+        {
+            num_reused_levels_ += n;
+        }
+        inline void count_cache_cubes (int n)
+        {
+            num_cache_cubes_ += n;
+        }
+        inline void count_cache_seeded ()
+        {
+            num_cache_seeded_ ++;
+        }
+        inline void count_compaction (int checked, int removed, double seconds)
+        {
+            num_compact_checked_ += checked;
+            num_compact_removed_ += removed;
+            time_compact_ += seconds;
+        }
+        inline void count_evicted (int n)
+        {
+            num_evicted_ += n;
+        }
+        inline void count_speculation (int ucs, double seconds)
+        {
+            num_spec_ucs_ += ucs;
+            time_spec_ += seconds;
+        }
+        inline void count_lemma_exported ()
+        {
+            num_lemmas_exported_ ++;
+        }
+        inline void count_lemma_imported ()
+        {
+            num_lemmas_imported_ ++;
+        }
+        inline void count_start_batch (int states)
+        {
+            num_start_batches_ ++;
+            num_start_batched_ += states;
+        }
+        inline void count_start_batch_stale ()
+        {
+            num_start_batch_stale_ ++;
+        }
+        inline void count_escalations (long long n, long long unsat)
+        {
+            num_escalations_ += n;
+            num_escalated_unsat_ += unsat;
+        }
+        inline long long lemmas_exported () const {return num_lemmas_exported_;}
+        inline long long lemmas_imported () const {return num_lemmas_imported_;}
+        inline void count_main_solver_search (long long decisions, long long conflicts)
+        {
+            num_main_solver_decisions_ += decisions;
+            num_main_solver_conflicts_ += conflicts;
+        }
         
     private:
         int num_SAT_calls_;
@@ -235,8 +336,9 @@ class Statistics
         int num_reduce_uc_SAT_calls_;
         double time_reduce_uc_SAT_calls_;
         double compress_reduce_uc_ratio_;
-        int orig_uc_size_;
-        int reduce_uc_size_;
+        long long orig_uc_size_;  //of the UCs before and after their minimization
+        long long reduce_uc_size_;
+        double time_minimal_uc_;
         
         int num_clause_contain_;
         int num_state_contain_;
@@ -247,6 +349,18 @@ class Statistics
         double time_detect_dead_state_SAT_calls_;
         
         int num_detect_dead_state_success_;
+        long long num_reused_levels_;  //decision levels kept by trail saving of the SAT solvers
+        long long num_main_solver_decisions_, num_main_solver_conflicts_;  //search effort of solver_, to measure -phase
+        int num_cache_cubes_, num_cache_seeded_;  //cubes read from the cache (-cache), and kept in the frames
+        int num_compact_checked_, num_compact_removed_;  //cubes of -compact
+        double time_compact_;
+        int num_evicted_;  //cubes of -evict
+        int num_spec_ucs_;  //UCs found by the workers of -spec
+        double time_spec_;
+        long long num_lemmas_exported_, num_lemmas_imported_;  //of -portfolio
+        long long num_start_batches_, num_start_batched_;  //of -bad-batch
+        long long num_start_batch_stale_;  //blocked by the frame before they were tried
+        long long num_escalations_, num_escalated_unsat_;  //of -parallel, an UNSAT one gives no smaller UC than the state
         
         clock_t begin_, end_;
         clock_t total_begin_, total_end_;
@@ -0,0 +1,117 @@
+/*
+    Copyright (C) 2018, Jianwen Li (lijwen2748@gmail.com), Iowa State University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * File:   concurrent_check.cpp
+ * Note: Checks of two different designs on two threads at the same time through
+ *       simplecar.h, each one repeated, and their verdicts (make test). A third thread
+ *       checks with a zero budget, which must stop its own checks only.
+ */
+
+//aiger.h is C, included first
+#include "../aigreader.h"
+#include "../simplecar.h"
+#include "../model.h"
+#include <thread>
+#include <atomic>
+#include <stdio.h>
+using namespace std;
+using namespace car;
+
+//a 3-bit counter, bad when all its bits are set: UNSAFE
+static const char* UNSAFE_AAG =
+	"aag 13 0 3 1 10\n2 3\n4 13\n6 21\n26\n"
+	"8 4 3\n10 5 2\n12 9 11\n14 4 2\n16 6 15\n18 7 14\n20 17 19\n22 6 14\n24 2 4\n26 24 6\n";
+
+//the same counter, bad only with a latch which stays 0: SAFE
+static const char* SAFE_AAG =
+	"aag 15 0 4 1 11\n2 3\n4 13\n6 21\n28 28\n30\n"
+	"8 4 3\n10 5 2\n12 9 11\n14 4 2\n16 6 15\n18 7 14\n20 17 19\n22 6 14\n24 2 4\n26 24 6\n30 26 28\n";
+
+static const int ROUNDS = 500;
+
+static int string_get (void* state)
+{
+	const char** p = (const char**) state;
+	return **p == 0 ? EOF : (unsigned char) *(*p)++;
+}
+
+static Model* read_model (const char* text)
+{
+	aiger* aig = aiger_init ();
+	if (aiger_read_generic (aig, &text, string_get) != NULL)
+	{
+		aiger_reset (aig);
+		return NULL;
+	}
+	if (!aiger_is_reencoded (aig))
+		aiger_reencode (aig);
+	Model* model = new Model (aig);
+	aiger_reset (aig);
+	return model;
+}
+
+static void run (Model* model, const bool forward, const long long budget, const Verdict expected, atomic<int>& failures)
+{
+	CheckOptions opts;
+	opts.forward = forward;
+	opts.propagation_budget = budget;
+	for (int i = 0; i < ROUNDS; i ++)
+	{
+		CheckResult res = check_model (model, opts);
+		if (res.verdict != expected)
+		{
+			failures ++;
+			fprintf (stderr, "round %d: verdict %d, expected %d (%s)\n", i, res.verdict, expected, res.reason.c_str ());
+		}
+	}
+}
+
+int main ()
+{
+	Model* unsafe = read_model (UNSAFE_AAG);
+	Model* safe = read_model (SAFE_AAG);
+	if (unsafe == NULL || safe == NULL)
+	{
+		fprintf (stderr, "cannot read the designs\n");
+		return 1;
+	}
+	atomic<int> failures (0);
+	//a single Checker runs each check, a portfolio is refused
+	CheckOptions portfolio;
+	portfolio.portfolio = true;
+	if (check_model (safe, portfolio).verdict != VERDICT_ERROR)
+	{
+		failures ++;
+		fprintf (stderr, "-portfolio was not refused\n");
+	}
+	thread t1 (run, unsafe, true, -1, VERDICT_UNSAFE, std::ref (failures));
+	thread t2 (run, safe, false, -1, VERDICT_SAFE, std::ref (failures));
+	thread t3 (run, unsafe, false, 0, VERDICT_UNKNOWN, std::ref (failures));
+	t1.join ();
+	t2.join ();
+	t3.join ();
+	delete unsafe;
+	delete safe;
+	if (failures > 0)
+	{
+		fprintf (stderr, "concurrent_check: %d failures\n", int (failures));
+		return 1;
+	}
+	printf ("concurrent_check: OK\n");
+	return 0;
+}